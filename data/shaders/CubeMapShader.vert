@@ -38,5 +38,6 @@ void main(void) {
     //textureCoords.y = -textureCoords.y;
 	textureCoords.x = -textureCoords.x;
 
-    gl_Position = transformationProjectionMatrix*position;
+    // At the far plane, so that it's only shaded where nothing else was drawn
+    gl_Position = (transformationProjectionMatrix*position).xyww;
 }
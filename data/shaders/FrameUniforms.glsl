@@ -0,0 +1,20 @@
+// The camera and light data of a frame, written once a frame by the Magnum scene and shared by its shaders, which
+// prepend this to their sources.  Matches `FrameUniforms` in the scene, laid out as std140.
+
+struct Eye {
+    mat4 viewMatrix;
+    mat4 projectionMatrix;
+    // Only used by stereo instancing, which draws both eyes into one viewport covering both.  The projection squeezes
+    // the eye's clip space into its part of that viewport, and the clip planes keep the eye's triangles within it
+    mat4 stereoProjectionMatrix;
+    vec4 clipPlanes[2];
+    vec4 cameraPosition;
+    // The light in the eye's view space
+    vec4 viewLightPosition;
+};
+
+layout(std140, binding = 0) uniform Frame {
+    Eye eyes[2];
+    // In world space
+    vec4 lightPosition;
+};
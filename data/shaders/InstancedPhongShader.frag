@@ -0,0 +1,36 @@
+// Matches the lighting of Magnum's Phong shader, with a single point light, evaluated in world space.  The light is
+// read from the Frame uniform block
+
+uniform vec4 ambientColor;
+uniform vec4 specularColor;
+uniform float shininess;
+#ifdef TEXTURED
+uniform sampler2D diffuseTexture;
+in vec2 interpolatedTextureCoordinates;
+#endif
+
+in vec3 worldPosition;
+in vec3 worldNormal;
+flat in vec3 cameraPosition;
+flat in vec4 diffuseColor;
+
+out vec4 fragmentColor;
+
+void main(void) {
+    vec4 diffuse = diffuseColor;
+#ifdef TEXTURED
+    diffuse *= texture(diffuseTexture, interpolatedTextureCoordinates);
+#endif
+
+    fragmentColor = ambientColor;
+    vec3 normalizedNormal = normalize(worldNormal);
+    vec3 lightDirection = normalize(lightPosition.xyz - worldPosition);
+    float intensity = max(0.0, dot(normalizedNormal, lightDirection));
+    fragmentColor += vec4(diffuse.rgb * intensity, diffuse.a);
+    if (intensity > 0.0) {
+        vec3 reflection = reflect(-lightDirection, normalizedNormal);
+        vec3 viewDirection = normalize(cameraPosition - worldPosition);
+        float specularity = pow(max(0.0, dot(viewDirection, reflection)), shininess);
+        fragmentColor += specularColor * specularity;
+    }
+}
@@ -0,0 +1,49 @@
+// Phong shading of every instance of a mesh in one draw.  Each instance's world transform and diffuse color come
+// from per-instance attributes, and each eye's view and projection from the Frame uniform block.  TEXTURED is defined
+// by the application when the diffuse color is modulated by a texture.
+//
+// With STEREO defined the mesh is drawn twice per instance, alternating eyes, into a viewport covering both eyes.
+// The per-instance attributes then advance every other instance, the stereo projections squeeze each eye's clip
+// space into its half of the viewport, and the clip planes keep each eye's triangles out of the other's half.
+
+#ifdef STEREO
+#define EYE_INDEX (gl_InstanceID % 2)
+#else
+uniform int eyeIndex;
+#define EYE_INDEX eyeIndex
+#endif
+
+in vec4 position;
+in vec3 normal;
+#ifdef TEXTURED
+in vec2 textureCoordinates;
+out vec2 interpolatedTextureCoordinates;
+#endif
+
+in mat4 instanceTransformation;
+in vec4 instanceColor;
+
+out vec3 worldPosition;
+out vec3 worldNormal;
+flat out vec3 cameraPosition;
+flat out vec4 diffuseColor;
+
+void main(void) {
+    Eye eye = eyes[EYE_INDEX];
+    vec4 world = instanceTransformation * position;
+    worldPosition = world.xyz;
+    // The transforms of glTF nodes may scale non-uniformly
+    worldNormal = transpose(inverse(mat3(instanceTransformation))) * normal;
+    cameraPosition = eye.cameraPosition.xyz;
+    diffuseColor = instanceColor;
+#ifdef TEXTURED
+    interpolatedTextureCoordinates = textureCoordinates;
+#endif
+#ifdef STEREO
+    gl_Position = eye.stereoProjectionMatrix * eye.viewMatrix * world;
+    gl_ClipDistance[0] = dot(eye.clipPlanes[0], gl_Position);
+    gl_ClipDistance[1] = dot(eye.clipPlanes[1], gl_Position);
+#else
+    gl_Position = eye.projectionMatrix * eye.viewMatrix * world;
+#endif
+}
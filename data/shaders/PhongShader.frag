@@ -0,0 +1,34 @@
+// Matches the lighting of Magnum's Phong shader, with a single point light, evaluated in view space
+
+uniform vec4 diffuseColor;
+uniform vec4 ambientColor;
+uniform vec4 specularColor;
+uniform float shininess;
+#ifdef TEXTURED
+uniform sampler2D diffuseTexture;
+in vec2 interpolatedTextureCoordinates;
+#endif
+
+in vec3 transformedNormal;
+in vec3 lightDirection;
+in vec3 cameraDirection;
+
+out vec4 fragmentColor;
+
+void main(void) {
+    vec4 diffuse = diffuseColor;
+#ifdef TEXTURED
+    diffuse *= texture(diffuseTexture, interpolatedTextureCoordinates);
+#endif
+
+    fragmentColor = ambientColor;
+    vec3 normalizedNormal = normalize(transformedNormal);
+    vec3 normalizedLightDirection = normalize(lightDirection);
+    float intensity = max(0.0, dot(normalizedNormal, normalizedLightDirection));
+    fragmentColor += vec4(diffuse.rgb * intensity, diffuse.a);
+    if (intensity > 0.0) {
+        vec3 reflection = reflect(-normalizedLightDirection, normalizedNormal);
+        float specularity = pow(max(0.0, dot(normalize(cameraDirection), reflection)), shininess);
+        fragmentColor += specularColor * specularity;
+    }
+}
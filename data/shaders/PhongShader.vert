@@ -0,0 +1,31 @@
+// Phong shading of a single object, like Magnum's Phong shader, but with the projection and light of each eye read
+// from the Frame uniform block, so that only the object's transformation relative to the eye and its color are set
+// per draw.  TEXTURED is defined by the application when the diffuse color is modulated by a texture.
+
+uniform int eyeIndex;
+// Relative to the eye
+uniform mat4 transformationMatrix;
+
+in vec4 position;
+in vec3 normal;
+#ifdef TEXTURED
+in vec2 textureCoordinates;
+out vec2 interpolatedTextureCoordinates;
+#endif
+
+out vec3 transformedNormal;
+out vec3 lightDirection;
+out vec3 cameraDirection;
+
+void main(void) {
+    vec4 transformedPosition4 = transformationMatrix * position;
+    vec3 transformedPosition = transformedPosition4.xyz / transformedPosition4.w;
+    // Like Magnum's Phong shader as the scene used it, with the normal matrix being the rotation and scaling
+    transformedNormal = mat3(transformationMatrix) * normal;
+    lightDirection = eyes[eyeIndex].viewLightPosition.xyz - transformedPosition;
+    cameraDirection = -transformedPosition;
+#ifdef TEXTURED
+    interpolatedTextureCoordinates = textureCoordinates;
+#endif
+    gl_Position = eyes[eyeIndex].projectionMatrix * transformedPosition4;
+}
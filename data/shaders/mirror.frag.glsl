@@ -0,0 +1,26 @@
+#version 450 core
+
+// LAYERED is defined by the application when the source is a texture array with one layer per eye
+#ifdef LAYERED
+layout(binding = 0) uniform sampler2DArray source;
+layout(location = 2) uniform float layer;
+#define SAMPLE(uv) texture(source, vec3(uv, layer))
+#else
+layout(binding = 0) uniform sampler2D source;
+#define SAMPLE(uv) texture(source, uv)
+#endif
+
+// A quarter of the source area covered by one output pixel, in texture coordinates.  Each of the four bilinear taps
+// averages a block of 2x2 texels, so together they cover the 4x4 footprint of the usual quarter size mirror
+layout(location = 1) uniform vec2 tapOffset;
+
+layout(location = 0) in vec2 _texCoord;
+layout(location = 0) out vec4 _fragColor;
+
+void main(void) {
+    vec3 color = SAMPLE(_texCoord + vec2(-tapOffset.x, -tapOffset.y)).rgb;
+    color += SAMPLE(_texCoord + vec2(tapOffset.x, -tapOffset.y)).rgb;
+    color += SAMPLE(_texCoord + vec2(-tapOffset.x, tapOffset.y)).rgb;
+    color += SAMPLE(_texCoord + vec2(tapOffset.x, tapOffset.y)).rgb;
+    _fragColor = vec4(color * 0.25, 1.0);
+}
@@ -0,0 +1,18 @@
+#version 450 core
+
+// The region of the source texture to draw, as an offset and size in texture coordinates
+layout(location = 0) uniform vec4 sourceRect;
+
+layout(location = 0) out vec2 _texCoord;
+
+void main(void) {
+    const vec2 UNIT_QUAD[4] = vec2[4](
+        vec2(0.0, 0.0),
+        vec2(1.0, 0.0),
+        vec2(0.0, 1.0),
+        vec2(1.0, 1.0)
+    );
+    vec2 corner = UNIT_QUAD[gl_VertexID];
+    _texCoord = sourceRect.xy + corner * sourceRect.zw;
+    gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);
+}
@@ -1,7 +1,15 @@
 #version 450 core
 
+// MULTIVIEW is defined by the application when rendering both eyes in one pass to a multiview framebuffer,
+// otherwise each eye is drawn separately with its index in `eyeIndex`
+#ifdef MULTIVIEW
 #extension GL_OVR_multiview : enable
 layout(num_views = 2) in;
+#define EYE_INDEX gl_ViewID_OVR
+#else
+layout(location = 0) uniform int eyeIndex;
+#define EYE_INDEX eyeIndex
+#endif
 
 layout(location=0) out vec3 _normal;
 
@@ -12,7 +20,7 @@ struct EyeView {
 	mat4 InverseViewMatrix;
 };
 
-layout (binding=0, std140) uniform EyeViews{
+layout (binding=1, std140) uniform EyeViews{
 	EyeView eyeView[2];
 } eyeViews;
 
@@ -27,8 +35,8 @@ void main(void) {
         vec4(1.0, 1.0, depth, 1.0)
     );
 
-	mat4 inverseProjection = eyeViews.eyeView[gl_ViewID_OVR].InverseProjectionMatrix;
-	mat4 inverseView = eyeViews.eyeView[gl_ViewID_OVR].InverseViewMatrix;
+	mat4 inverseProjection = eyeViews.eyeView[EYE_INDEX].InverseProjectionMatrix;
+	mat4 inverseView = eyeViews.eyeView[EYE_INDEX].InverseViewMatrix;
 
     vec4 inPosition = UNIT_QUAD[gl_VertexID];
     vec3 clipDir = vec3(inPosition.xy, 0.0);
@@ -34,6 +34,7 @@
 #include <stdexcept>
 #include <streambuf>
 #include <thread>
+#include <type_traits>
 #include <vector>
 
 #include <fmt/format.h>
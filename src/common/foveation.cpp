@@ -0,0 +1,47 @@
+//
+//  Created by Bradley Austin Davis
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#include "foveation.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace xr_examples;
+
+xr::Extent2Di Foveation::getInsetSize(const xr::Extent2Di& eyeSize) const {
+    auto fraction = std::min(std::max(insetFraction, 0.0f), 1.0f);
+    return { std::max((int32_t)std::lround((float)eyeSize.width * fraction), 1),
+             std::max((int32_t)std::lround((float)eyeSize.height * fraction), 1) };
+}
+
+// Pixels are evenly spaced in the tangent of the view angle, not the angle itself
+xr::Rect2Di Foveation::getInsetRect(const xr::Extent2Di& eyeSize, const xr::Fovf& fov) const {
+    xr::Rect2Di result;
+    result.extent = getInsetSize(eyeSize);
+    auto tanLeft = std::tan(fov.angleLeft), tanRight = std::tan(fov.angleRight);
+    auto tanDown = std::tan(fov.angleDown), tanUp = std::tan(fov.angleUp);
+    auto axisX = -tanLeft / (tanRight - tanLeft) * (float)eyeSize.width;
+    auto axisY = -tanDown / (tanUp - tanDown) * (float)eyeSize.height;
+    result.offset.x = (int32_t)std::lround(axisX - (float)result.extent.width / 2.0f);
+    result.offset.y = (int32_t)std::lround(axisY - (float)result.extent.height / 2.0f);
+    result.offset.x = std::min(std::max(result.offset.x, 0), eyeSize.width - result.extent.width);
+    result.offset.y = std::min(std::max(result.offset.y, 0), eyeSize.height - result.extent.height);
+    return result;
+}
+
+xr::Fovf Foveation::getInsetFov(const xr::Extent2Di& eyeSize, const xr::Fovf& fov, const xr::Rect2Di& insetRect) {
+    auto tanLeft = std::tan(fov.angleLeft), tanRight = std::tan(fov.angleRight);
+    auto tanDown = std::tan(fov.angleDown), tanUp = std::tan(fov.angleUp);
+    auto tanX = [&](int32_t x) { return tanLeft + (tanRight - tanLeft) * (float)x / (float)eyeSize.width; };
+    auto tanY = [&](int32_t y) { return tanDown + (tanUp - tanDown) * (float)y / (float)eyeSize.height; };
+
+    xr::Fovf result;
+    result.angleLeft = std::atan(tanX(insetRect.offset.x));
+    result.angleRight = std::atan(tanX(insetRect.offset.x + insetRect.extent.width));
+    result.angleDown = std::atan(tanY(insetRect.offset.y));
+    result.angleUp = std::atan(tanY(insetRect.offset.y + insetRect.extent.height));
+    return result;
+}
@@ -0,0 +1,36 @@
+//
+//  Created by Bradley Austin Davis
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#pragma once
+
+#include <openxr/openxr.hpp>
+
+namespace xr_examples {
+
+// Fixed foveation for a double wide eye layout.  The lenses of an HMD undersample the edges of each eye's image, so
+// shading them at full resolution is mostly wasted.  Instead each eye's whole field of view, the periphery, is
+// rendered at `peripheryScale` of the full resolution, and a full resolution inset covering `insetFraction` of the
+// eye's width and height is rendered around the optical axis, where the lenses are sharpest.  The inset is then
+// composited over the upscaled periphery.
+//
+// The two knobs trade quality for GPU time.  The fraction of the full resolution pixels that are shaded is the sum of
+// their squares, so half of them at the defaults, see `getShadedFraction()`.
+struct Foveation {
+    float insetFraction{ 0.5f };
+    float peripheryScale{ 0.5f };
+
+    float getShadedFraction() const { return peripheryScale * peripheryScale + insetFraction * insetFraction; }
+    // The size of the inset of an eye of `eyeSize` pixels
+    xr::Extent2Di getInsetSize(const xr::Extent2Di& eyeSize) const;
+    // Where the inset goes within an eye of `eyeSize` pixels with the field of view `fov`.  It's centered on the
+    // optical axis, as far as that's possible without it leaving the eye's image.
+    xr::Rect2Di getInsetRect(const xr::Extent2Di& eyeSize, const xr::Fovf& fov) const;
+    // The part of `fov` that `insetRect` of the eye's image covers, so that the inset lines up exactly with the
+    // periphery it's composited over
+    static xr::Fovf getInsetFov(const xr::Extent2Di& eyeSize, const xr::Fovf& fov, const xr::Rect2Di& insetRect);
+};
+
+}  // namespace xr_examples
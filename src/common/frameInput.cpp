@@ -0,0 +1,203 @@
+//
+//  Created by Bradley Austin Davis
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#include "frameInput.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#if defined(WIN32)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <logging.hpp>
+
+using namespace xr_examples;
+
+void FrameInput::set(const xr::FrameState& frameState, const EyeStates& eyeStates, const HandStates& handStates) {
+    memset(this, 0, sizeof(FrameInput));
+    predictedDisplayTime = frameState.predictedDisplayTime.get();
+    predictedDisplayPeriod = frameState.predictedDisplayPeriod.get();
+    shouldRender = frameState.shouldRender ? 1 : 0;
+    for (uint32_t i = 0; i < 2; ++i) {
+        eyes[i].pose = reinterpret_cast<const XrPosef&>(eyeStates[i].pose);
+        eyes[i].fov = reinterpret_cast<const XrFovf&>(eyeStates[i].fov);
+
+        const auto& handState = handStates[i];
+        auto& hand = hands[i];
+        hand.grip = reinterpret_cast<const XrPosef&>(handState.grip);
+        hand.aim = reinterpret_cast<const XrPosef&>(handState.aim);
+        hand.thumb = reinterpret_cast<const XrVector2f&>(handState.thumb);
+        hand.squeeze = handState.squeeze;
+        hand.trigger = handState.trigger;
+        hand.flags = 0;
+        hand.flags |= handState.squeezeTouched ? Hand::SqueezeTouched : 0;
+        hand.flags |= handState.triggerTouched ? Hand::TriggerTouched : 0;
+        hand.flags |= handState.thumbClicked ? Hand::ThumbClicked : 0;
+        hand.flags |= handState.thumbTouched ? Hand::ThumbTouched : 0;
+    }
+}
+
+void FrameInput::getEyeStates(EyeStates& eyeStates) const {
+    for (uint32_t i = 0; i < 2; ++i) {
+        eyeStates[i].pose = reinterpret_cast<const xr::Posef&>(eyes[i].pose);
+        eyeStates[i].fov = reinterpret_cast<const xr::Fovf&>(eyes[i].fov);
+    }
+}
+
+void FrameInput::getHandStates(HandStates& handStates) const {
+    for (uint32_t i = 0; i < 2; ++i) {
+        const auto& hand = hands[i];
+        auto& handState = handStates[i];
+        handState.grip = reinterpret_cast<const xr::Posef&>(hand.grip);
+        handState.aim = reinterpret_cast<const xr::Posef&>(hand.aim);
+        handState.thumb = reinterpret_cast<const xr::Vector2f&>(hand.thumb);
+        handState.squeeze = hand.squeeze;
+        handState.trigger = hand.trigger;
+        handState.squeezeTouched = 0 != (hand.flags & Hand::SqueezeTouched);
+        handState.triggerTouched = 0 != (hand.flags & Hand::TriggerTouched);
+        handState.thumbClicked = 0 != (hand.flags & Hand::ThumbClicked);
+        handState.thumbTouched = 0 != (hand.flags & Hand::ThumbTouched);
+    }
+}
+
+bool FrameInputRecorder::open(const std::string& path, const xr::Extent2Di& renderTargetSize) {
+    close();
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        LOG_ERROR("Unable to open frame input recording {}", path);
+        return false;
+    }
+    header = FrameInputHeader{};
+    header.renderTargetWidth = renderTargetSize.width;
+    header.renderTargetHeight = renderTargetSize.height;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(FrameInputHeader));
+    return true;
+}
+
+void FrameInputRecorder::write(const FrameInput& frameInput) {
+    file.write(reinterpret_cast<const char*>(&frameInput), sizeof(FrameInput));
+    ++header.frameCount;
+}
+
+void FrameInputRecorder::close() {
+    if (!file.is_open()) {
+        return;
+    }
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(FrameInputHeader));
+    file.close();
+    LOG_INFO("Recorded {} frames of input", header.frameCount);
+}
+
+bool FrameInputPlayer::open(const std::string& path) {
+    close();
+#if defined(WIN32)
+    fileHandle =
+        CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        fileHandle = nullptr;
+        LOG_ERROR("Unable to open frame input recording {}", path);
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize)) {
+        LOG_ERROR("Unable to get the size of frame input recording {}", path);
+        close();
+        return false;
+    }
+    length = (size_t)fileSize.QuadPart;
+    mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle) {
+        data = (const uint8_t*)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    }
+#else
+    fileDescriptor = ::open(path.c_str(), O_RDONLY);
+    if (fileDescriptor < 0) {
+        LOG_ERROR("Unable to open frame input recording {}", path);
+        return false;
+    }
+    struct stat fileStat;
+    if (0 != fstat(fileDescriptor, &fileStat)) {
+        LOG_ERROR("Unable to get the size of frame input recording {}", path);
+        close();
+        return false;
+    }
+    length = (size_t)fileStat.st_size;
+    if (length != 0) {
+        auto mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+        data = mapped == MAP_FAILED ? nullptr : (const uint8_t*)mapped;
+    }
+#endif
+    if (!data) {
+        LOG_ERROR("Unable to map frame input recording {}", path);
+        close();
+        return false;
+    }
+
+    if (length < sizeof(FrameInputHeader)) {
+        LOG_ERROR("{} is not a compatible frame input recording", path);
+        close();
+        return false;
+    }
+    const auto& header = getHeader();
+    if (header.magic != FrameInputHeader::MAGIC ||
+        header.version != FrameInputHeader::VERSION || header.recordSize != sizeof(FrameInput)) {
+        LOG_ERROR("{} is not a compatible frame input recording", path);
+        close();
+        return false;
+    }
+
+    frameCount = (length - sizeof(FrameInputHeader)) / sizeof(FrameInput);
+    if (header.frameCount != 0) {
+        frameCount = std::min<size_t>(frameCount, header.frameCount);
+    }
+    LOG_INFO("Replaying {} frames of input from {}", frameCount, path);
+    return true;
+}
+
+void FrameInputPlayer::close() {
+#if defined(WIN32)
+    if (data) {
+        UnmapViewOfFile(data);
+    }
+    if (mappingHandle) {
+        CloseHandle(mappingHandle);
+        mappingHandle = nullptr;
+    }
+    if (fileHandle) {
+        CloseHandle(fileHandle);
+        fileHandle = nullptr;
+    }
+#else
+    if (data) {
+        munmap(const_cast<uint8_t*>(data), length);
+    }
+    if (fileDescriptor >= 0) {
+        ::close(fileDescriptor);
+        fileDescriptor = -1;
+    }
+#endif
+    data = nullptr;
+    length = 0;
+    frameCount = 0;
+}
+
+xr::Extent2Di FrameInputPlayer::getRenderTargetSize() const {
+    const auto& header = getHeader();
+    return { header.renderTargetWidth, header.renderTargetHeight };
+}
+
+const FrameInput& FrameInputPlayer::get(size_t index) const {
+    assert(index < frameCount);
+    return reinterpret_cast<const FrameInput*>(data + sizeof(FrameInputHeader))[index];
+}
@@ -0,0 +1,113 @@
+//
+//  Created by Bradley Austin Davis
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <type_traits>
+
+#include <interfaces.hpp>
+
+namespace xr_examples {
+
+// The per-frame XR input the examples consume, as a fixed size record.  Only plain C OpenXR structs are used so
+// the layout is the same for every compiler the examples are built with.
+struct FrameInput {
+    struct Eye {
+        XrPosef pose;
+        XrFovf fov;
+    };
+
+    struct Hand {
+        enum Flags : uint32_t
+        {
+            SqueezeTouched = 0x1,
+            TriggerTouched = 0x2,
+            ThumbClicked = 0x4,
+            ThumbTouched = 0x8,
+        };
+
+        XrPosef grip;
+        XrPosef aim;
+        XrVector2f thumb;
+        float squeeze;
+        float trigger;
+        uint32_t flags;
+        uint32_t padding;
+    };
+
+    int64_t predictedDisplayTime;
+    int64_t predictedDisplayPeriod;
+    uint32_t shouldRender;
+    uint32_t padding;
+    Eye eyes[2];
+    Hand hands[2];
+
+    void set(const xr::FrameState& frameState, const EyeStates& eyeStates, const HandStates& handStates);
+    void getEyeStates(EyeStates& eyeStates) const;
+    void getHandStates(HandStates& handStates) const;
+};
+
+static_assert(std::is_trivially_copyable<FrameInput>::value, "FrameInput records are written as raw bytes");
+
+// A recording is a header followed by `frameCount` FrameInput records, in the byte order of the machine that wrote
+// it.  `frameCount` is only written when the recording is closed, and is zero if the writer didn't shut down
+// cleanly, in which case the count is derived from the file size.
+struct FrameInputHeader {
+    static constexpr uint32_t MAGIC = 0x52495258;  // "XRIR"
+    static constexpr uint32_t VERSION = 1;
+
+    uint32_t magic{ MAGIC };
+    uint32_t version{ VERSION };
+    uint32_t recordSize{ sizeof(FrameInput) };
+    uint32_t frameCount{ 0 };
+    int32_t renderTargetWidth{ 0 };
+    int32_t renderTargetHeight{ 0 };
+};
+
+class FrameInputRecorder {
+public:
+    ~FrameInputRecorder() { close(); }
+
+    bool open(const std::string& path, const xr::Extent2Di& renderTargetSize);
+    void write(const FrameInput& frameInput);
+    void close();
+    bool isOpen() const { return file.is_open(); }
+
+private:
+    std::ofstream file;
+    FrameInputHeader header;
+};
+
+// Memory maps a recording, so replaying it costs no more than reading from memory
+class FrameInputPlayer {
+public:
+    ~FrameInputPlayer() { close(); }
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return nullptr != data; }
+
+    const FrameInputHeader& getHeader() const { return *reinterpret_cast<const FrameInputHeader*>(data); }
+    xr::Extent2Di getRenderTargetSize() const;
+    size_t size() const { return frameCount; }
+    const FrameInput& get(size_t index) const;
+
+private:
+    const uint8_t* data{ nullptr };
+    size_t length{ 0 };
+    size_t frameCount{ 0 };
+#if defined(WIN32)
+    void* fileHandle{ nullptr };
+    void* mappingHandle{ nullptr };
+#else
+    int fileDescriptor{ -1 };
+#endif
+};
+
+}  // namespace xr_examples
@@ -0,0 +1,258 @@
+//
+//  Created by Bradley Austin Davis
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#include "frameTimings.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <fstream>
+
+#include <logging.hpp>
+
+using namespace xr_examples;
+
+const char* xr_examples::getFramePhaseName(FramePhase phase) {
+    switch (phase) {
+        case FramePhase::PollEvents:
+            return "pollEvents";
+        case FramePhase::SyncActions:
+            return "syncActions";
+        case FramePhase::WaitFrame:
+            return "waitFrame";
+        case FramePhase::BeginFrame:
+            return "beginFrame";
+        case FramePhase::UpdateHandStates:
+            return "updateHandStates";
+        case FramePhase::RenderSceneLayer:
+            return "renderSceneLayer";
+        case FramePhase::BlitToProjection:
+            return "blitToProjection";
+        case FramePhase::RenderExtraLayers:
+            return "renderExtraLayers";
+        case FramePhase::SubmitFrame:
+            return "submitFrame";
+        case FramePhase::BlitToWindow:
+            return "blitToWindow";
+        default:
+            break;
+    }
+    return "unknown";
+}
+
+void FrameRecord::reset(uint64_t index) {
+    frameIndex = index;
+    predictedDisplayTime = 0;
+    frameDuration = 0.0f;
+    phaseStart.fill(-1.0f);
+    phaseDuration.fill(0.0f);
+    poseLocated = -1.0f;
+    poseAge = -1.0f;
+    poseAgeRemoved = 0.0f;
+    renderScale = 1.0f;
+}
+
+float FrameTimings::millisecondsSinceFrameStart(const Clock::time_point& time) const {
+    return std::chrono::duration<float, std::milli>(time - frameStart).count();
+}
+
+void FrameTimings::beginFrame(uint64_t frameIndex) {
+    frameStart = Clock::now();
+    current.reset(frameIndex);
+    firstPoseLocated = -1.0f;
+}
+
+void FrameTimings::endFrame() {
+    current.frameDuration = millisecondsSinceFrameStart(Clock::now());
+    records[next] = current;
+    next = (next + 1) % CAPACITY;
+    count = std::min(count + 1, CAPACITY);
+}
+
+void FrameTimings::beginPhase(FramePhase phase) {
+    current.phaseStart[static_cast<size_t>(phase)] = millisecondsSinceFrameStart(Clock::now());
+}
+
+void FrameTimings::endPhase(FramePhase phase) {
+    auto index = static_cast<size_t>(phase);
+    current.phaseDuration[index] = millisecondsSinceFrameStart(Clock::now()) - current.phaseStart[index];
+}
+
+void FrameTimings::markPoseLocated() {
+    current.poseLocated = millisecondsSinceFrameStart(Clock::now());
+    if (firstPoseLocated < 0.0f) {
+        firstPoseLocated = current.poseLocated;
+    }
+}
+
+void FrameTimings::markPoseConsumed() {
+    if (current.poseLocated < 0.0f) {
+        return;
+    }
+    current.poseAge = millisecondsSinceFrameStart(Clock::now()) - current.poseLocated;
+    current.poseAgeRemoved = current.poseLocated - firstPoseLocated;
+}
+
+const FrameRecord& FrameTimings::getRecord(size_t age) const {
+    assert(age < count);
+    return records[(next + CAPACITY - 1 - age) % CAPACITY];
+}
+
+template <typename F>
+TimingStats FrameTimings::computeStats(F&& sampler) const {
+    // Scratch space lives on the stack so that queries don't allocate either
+    std::array<float, CAPACITY> samples;
+    TimingStats result;
+    float total = 0.0f;
+    for (size_t age = 0; age < count; ++age) {
+        float sample;
+        if (!sampler(getRecord(age), sample)) {
+            continue;
+        }
+        samples[result.samples++] = sample;
+        total += sample;
+    }
+
+    if (0 == result.samples) {
+        return result;
+    }
+
+    auto begin = samples.begin();
+    auto end = begin + result.samples;
+    auto p99 = begin + std::min<size_t>(result.samples - 1, (result.samples * 99) / 100);
+    std::nth_element(begin, p99, end);
+    result.p99 = *p99;
+    result.min = *std::min_element(begin, end);
+    result.avg = total / (float)result.samples;
+    return result;
+}
+
+TimingStats FrameTimings::getPhaseStats(FramePhase phase) const {
+    return computeStats([&](const FrameRecord& record, float& sample) {
+        if (!record.hasPhase(phase)) {
+            return false;
+        }
+        sample = record.phaseDuration[static_cast<size_t>(phase)];
+        return true;
+    });
+}
+
+TimingStats FrameTimings::getFrameStats() const {
+    return computeStats([&](const FrameRecord& record, float& sample) {
+        sample = record.frameDuration;
+        return true;
+    });
+}
+
+TimingStats FrameTimings::getPoseAgeStats() const {
+    return computeStats([&](const FrameRecord& record, float& sample) {
+        sample = record.poseAge;
+        return record.poseAge >= 0.0f;
+    });
+}
+
+TimingStats FrameTimings::getPoseAgeRemovedStats() const {
+    return computeStats([&](const FrameRecord& record, float& sample) {
+        sample = record.poseAgeRemoved;
+        return record.poseAge >= 0.0f;
+    });
+}
+
+TimingStats FrameTimings::getRenderScaleStats() const {
+    return computeStats([&](const FrameRecord& record, float& sample) {
+        sample = record.renderScale;
+        return true;
+    });
+}
+
+void FrameTimings::logSummary() const {
+    auto frameStats = getFrameStats();
+    LOG_INFO("Frame timings over {} frames: min {:.3f} ms, avg {:.3f} ms, p99 {:.3f} ms", frameStats.samples, frameStats.min,
+             frameStats.avg, frameStats.p99);
+    auto poseAgeStats = getPoseAgeStats();
+    if (0 != poseAgeStats.samples) {
+        auto removedStats = getPoseAgeRemovedStats();
+        LOG_INFO("    {:<20} min {:.3f} ms, avg {:.3f} ms, p99 {:.3f} ms (avg {:.3f} ms removed by late latching)", "poseAge",
+                 poseAgeStats.min, poseAgeStats.avg, poseAgeStats.p99, removedStats.avg);
+    }
+    auto renderScaleStats = getRenderScaleStats();
+    if (renderScaleStats.min < 1.0f) {
+        LOG_INFO("    {:<20} min {:.3f}, avg {:.3f}", "renderScale", renderScaleStats.min, renderScaleStats.avg);
+    }
+    for (size_t i = 0; i < FRAME_PHASE_COUNT; ++i) {
+        auto phase = static_cast<FramePhase>(i);
+        auto stats = getPhaseStats(phase);
+        if (0 == stats.samples) {
+            continue;
+        }
+        LOG_INFO("    {:<20} min {:.3f} ms, avg {:.3f} ms, p99 {:.3f} ms", getFramePhaseName(phase), stats.min, stats.avg,
+                 stats.p99);
+    }
+}
+
+bool FrameTimings::write(const std::string& path) const {
+    static const std::string JSON_EXTENSION{ ".json" };
+    if (path.size() >= JSON_EXTENSION.size() &&
+        0 == path.compare(path.size() - JSON_EXTENSION.size(), JSON_EXTENSION.size(), JSON_EXTENSION)) {
+        return writeJson(path);
+    }
+    return writeCsv(path);
+}
+
+bool FrameTimings::writeCsv(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file) {
+        LOG_ERROR("Unable to open frame timings file {}", path);
+        return false;
+    }
+
+    file << "frameIndex,predictedDisplayTime,frameDuration,poseAge,poseAgeRemoved,renderScale";
+    for (size_t i = 0; i < FRAME_PHASE_COUNT; ++i) {
+        auto name = getFramePhaseName(static_cast<FramePhase>(i));
+        file << "," << name << "Start," << name << "Duration";
+    }
+    file << "\n";
+
+    for (size_t age = count; age > 0; --age) {
+        const auto& record = getRecord(age - 1);
+        file << fmt::format("{},{},{:.4f},{:.4f},{:.4f},{:.4f}", record.frameIndex, record.predictedDisplayTime,
+                            record.frameDuration, record.poseAge, record.poseAgeRemoved, record.renderScale);
+        for (size_t i = 0; i < FRAME_PHASE_COUNT; ++i) {
+            file << fmt::format(",{:.4f},{:.4f}", record.phaseStart[i], record.phaseDuration[i]);
+        }
+        file << "\n";
+    }
+    return true;
+}
+
+bool FrameTimings::writeJson(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file) {
+        LOG_ERROR("Unable to open frame timings file {}", path);
+        return false;
+    }
+
+    file << "{\n  \"frames\": [";
+    for (size_t age = count; age > 0; --age) {
+        const auto& record = getRecord(age - 1);
+        file << (age == count ? "\n" : ",\n");
+        file << fmt::format("    {{ \"frameIndex\": {}, \"predictedDisplayTime\": {}, \"frameDuration\": {:.4f}, "
+                            "\"poseAge\": {:.4f}, \"poseAgeRemoved\": {:.4f}, \"renderScale\": {:.4f}, \"phases\": {{",
+                            record.frameIndex, record.predictedDisplayTime, record.frameDuration, record.poseAge,
+                            record.poseAgeRemoved, record.renderScale);
+        bool first = true;
+        for (size_t i = 0; i < FRAME_PHASE_COUNT; ++i) {
+            if (!record.hasPhase(static_cast<FramePhase>(i))) {
+                continue;
+            }
+            file << fmt::format("{} \"{}\": {{ \"start\": {:.4f}, \"duration\": {:.4f} }}", first ? "" : ",",
+                                getFramePhaseName(static_cast<FramePhase>(i)), record.phaseStart[i], record.phaseDuration[i]);
+            first = false;
+        }
+        file << " } }";
+    }
+    file << "\n  ]\n}\n";
+    return true;
+}
@@ -0,0 +1,120 @@
+//
+//  Created by Bradley Austin Davis
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace xr_examples {
+
+enum class FramePhase : uint32_t
+{
+    PollEvents = 0,
+    SyncActions,
+    WaitFrame,
+    BeginFrame,
+    UpdateHandStates,
+    RenderSceneLayer,
+    BlitToProjection,
+    RenderExtraLayers,
+    SubmitFrame,
+    BlitToWindow,
+    Count,
+};
+
+static constexpr size_t FRAME_PHASE_COUNT = static_cast<size_t>(FramePhase::Count);
+
+const char* getFramePhaseName(FramePhase phase);
+
+// All times are in milliseconds, relative to the start of the frame.  Phases that did not run during the
+// frame have a negative start time.
+struct FrameRecord {
+    uint64_t frameIndex{ 0 };
+    int64_t predictedDisplayTime{ 0 };
+    float frameDuration{ 0.0f };
+    std::array<float, FRAME_PHASE_COUNT> phaseStart;
+    std::array<float, FRAME_PHASE_COUNT> phaseDuration;
+    // When the eye poses used for rendering were located, and how old they were by the time the scene's draw calls
+    // had been submitted.  `poseAgeRemoved` is how much later than the first locate of the frame those poses were
+    // located, i.e. the age saved by late latching.  `poseAge` is negative if no poses were consumed.
+    float poseLocated{ -1.0f };
+    float poseAge{ -1.0f };
+    float poseAgeRemoved{ 0.0f };
+    // Per-axis scale of the rendered eye viewports, see `ResolutionScaler`
+    float renderScale{ 1.0f };
+
+    bool hasPhase(FramePhase phase) const { return phaseStart[static_cast<size_t>(phase)] >= 0.0f; }
+    void reset(uint64_t index);
+};
+
+struct TimingStats {
+    uint32_t samples{ 0 };
+    float min{ 0.0f };
+    float avg{ 0.0f };
+    float p99{ 0.0f };
+};
+
+// Fixed size ring of per-frame phase timings.  Recording a frame never allocates.
+class FrameTimings {
+public:
+    static constexpr size_t CAPACITY = 1024;
+    using Clock = std::chrono::steady_clock;
+
+    class ScopedPhase {
+    public:
+        ScopedPhase(FrameTimings& timings, FramePhase phase) : timings(timings), phase(phase) { timings.beginPhase(phase); }
+        ~ScopedPhase() { timings.endPhase(phase); }
+
+    private:
+        FrameTimings& timings;
+        const FramePhase phase;
+    };
+
+    void beginFrame(uint64_t frameIndex);
+    void endFrame();
+    void beginPhase(FramePhase phase);
+    void endPhase(FramePhase phase);
+    ScopedPhase scoped(FramePhase phase) { return ScopedPhase(*this, phase); }
+    void setPredictedDisplayTime(int64_t predictedDisplayTime) { current.predictedDisplayTime = predictedDisplayTime; }
+    void setRenderScale(float renderScale) { current.renderScale = renderScale; }
+    // Call every time the eye poses are located, and once when the draw calls using the latest ones are submitted
+    void markPoseLocated();
+    void markPoseConsumed();
+
+    // Number of completed frames held in the ring
+    size_t size() const { return count; }
+    // Age 0 is the most recently completed frame
+    const FrameRecord& getRecord(size_t age) const;
+
+    TimingStats getPhaseStats(FramePhase phase) const;
+    TimingStats getFrameStats() const;
+    TimingStats getPoseAgeStats() const;
+    TimingStats getPoseAgeRemovedStats() const;
+    TimingStats getRenderScaleStats() const;
+
+    void logSummary() const;
+    // Writes every record in the ring.  The format is picked from the extension, `.json` or CSV otherwise
+    bool write(const std::string& path) const;
+    bool writeCsv(const std::string& path) const;
+    bool writeJson(const std::string& path) const;
+
+private:
+    float millisecondsSinceFrameStart(const Clock::time_point& time) const;
+    template <typename F>
+    TimingStats computeStats(F&& sampler) const;
+
+    std::array<FrameRecord, CAPACITY> records;
+    FrameRecord current;
+    Clock::time_point frameStart;
+    float firstPoseLocated{ -1.0f };
+    size_t next{ 0 };
+    size_t count{ 0 };
+};
+
+}  // namespace xr_examples
@@ -0,0 +1,87 @@
+#include "eyeViews.hpp"
+#include "math.hpp"
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include <logging.hpp>
+
+namespace xr_examples { namespace gl {
+
+void EyeViews::update(const EyeStates& eyeStates, float nearZ, float farZ) {
+    xr::for_each_side_index([&](uint32_t eyeIndex) {
+        const auto& eyeState = eyeStates[eyeIndex];
+        auto& eye = eyes[eyeIndex];
+        eye.projection = toGlm(eyeState.fov, nearZ, farZ);
+        eye.inverseProjection = glm::inverse(eye.projection);
+        eye.inverseView = toGlm(eyeState.pose);
+        eye.view = glm::inverse(eye.inverseView);
+    });
+}
+
+void EyeViewsUniformBuffer::create() {
+    GLint alignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    alignment = std::max(alignment, 1);
+    regionSize = (uint32_t)(((sizeof(EyeViews) + alignment - 1) / alignment) * alignment);
+
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glCreateBuffers(1, &buffer);
+    glNamedBufferStorage(buffer, regionSize * REGIONS, nullptr, flags);
+    mapped = (uint8_t*)glMapNamedBufferRange(buffer, 0, regionSize * REGIONS, flags);
+    if (!mapped) {
+        throw std::runtime_error("Unable to map the eye views buffer");
+    }
+    region = 0;
+}
+
+void EyeViewsUniformBuffer::destroy() {
+    for (auto& fence : fences) {
+        fence.destroy();
+    }
+    if (buffer) {
+        glUnmapNamedBuffer(buffer);
+        glDeleteBuffers(1, &buffer);
+        buffer = 0;
+        mapped = nullptr;
+    }
+}
+
+void EyeViewsUniformBuffer::waitForRegion(uint32_t index) {
+    // The region was fenced REGIONS writes ago, so in practice this never blocks
+    if (!fences[index].clientWait()) {
+        LOG_WARN("Timed out waiting for eye views region {}", index);
+        fences[index].destroy();
+    }
+}
+
+void EyeViewsUniformBuffer::write(const EyeViews& eyeViews) {
+    waitForRegion(region);
+    memcpy(mapped + region * regionSize, &eyeViews, sizeof(EyeViews));
+}
+
+void EyeViewsUniformBuffer::write(const EyeStates& eyeStates, float nearZ, float farZ) {
+    EyeViews eyeViews;
+    eyeViews.update(eyeStates, nearZ, farZ);
+    write(eyeViews);
+}
+
+void EyeViewsUniformBuffer::latch(const EyeStates& eyeStates, float nearZ, float farZ) {
+    // The region was already waited for by `write()`, and the GPU can't have started the draws that read it
+    EyeViews eyeViews;
+    eyeViews.update(eyeStates, nearZ, farZ);
+    memcpy(mapped + region * regionSize, &eyeViews, sizeof(EyeViews));
+}
+
+void EyeViewsUniformBuffer::bind(uint32_t binding) const {
+    glBindBufferRange(GL_UNIFORM_BUFFER, binding, buffer, region * regionSize, sizeof(EyeViews));
+}
+
+void EyeViewsUniformBuffer::advance() {
+    fences[region].insert();
+    region = (region + 1) % REGIONS;
+}
+
+}}  // namespace xr_examples::gl
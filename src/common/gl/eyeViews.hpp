@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <glm/glm.hpp>
+
+#include <interfaces.hpp>
+#include <gl/fence.hpp>
+
+namespace xr_examples { namespace gl {
+
+// Matches the std140 `EyeViews` uniform block declared by the shaders, e.g. `skybox.vert.glsl`
+struct EyeView {
+    glm::mat4 projection;
+    glm::mat4 inverseProjection;
+    glm::mat4 view;
+    glm::mat4 inverseView;
+};
+
+struct EyeViews {
+    std::array<EyeView, 2> eyes;
+
+    void update(const EyeStates& eyeStates, float nearZ, float farZ);
+};
+
+// The `EyeViews` uniform block, in a persistently and coherently mapped buffer holding several copies of it, one per
+// write in flight (two per frame with foveated rendering, which renders the inset with its own views), each fenced so
+// that a write never lands on a copy the GPU may still be reading.
+//
+// Because the mapping is coherent the views can be late latched: `write()` the views before issuing the draws that
+// read them, then `latch()` fresher views into the same copy once the draws have been issued, but before anything
+// flushes them to the GPU, which then reads the latched views.  `advance()` flushes.
+class EyeViewsUniformBuffer {
+public:
+    static constexpr uint32_t REGIONS = 6;
+    // Binding 0 is left to the scenes' own uniform blocks, like the Magnum scene's `Frame` block
+    static constexpr uint32_t DEFAULT_BINDING = 1;
+
+    void create();
+    void destroy();
+
+    void write(const EyeViews& eyeViews);
+    void write(const EyeStates& eyeStates, float nearZ, float farZ);
+    // Binds the region written this frame to the given uniform buffer binding point
+    void bind(uint32_t binding = DEFAULT_BINDING) const;
+    // Overwrites the current region, after the draws that read it have been issued and before they're flushed
+    void latch(const EyeStates& eyeStates, float nearZ, float farZ);
+    // Inserts a fence after the draws that read the current region, so it isn't written again until the GPU is done
+    // with them, and moves on to the next region.  Inserting the fence flushes the draws, so the region can't be
+    // latched after this.  Call after every write, once the draws that read it have been issued.
+    void advance();
+
+private:
+    void waitForRegion(uint32_t index);
+
+    uint32_t buffer{ 0 };
+    uint32_t regionSize{ 0 };
+    uint32_t region{ 0 };
+    uint8_t* mapped{ nullptr };
+    std::array<Fence, REGIONS> fences;
+};
+
+}}  // namespace xr_examples::gl
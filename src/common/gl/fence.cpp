@@ -0,0 +1,53 @@
+#include "fence.hpp"
+
+#include <utility>
+
+#include <glad/glad.h>
+
+using namespace xr_examples::gl;
+
+Fence::Fence(Fence&& other) noexcept : sync(std::exchange(other.sync, nullptr)) {
+}
+
+Fence& Fence::operator=(Fence&& other) noexcept {
+    if (this != &other) {
+        destroy();
+        sync = std::exchange(other.sync, nullptr);
+    }
+    return *this;
+}
+
+void Fence::insert() {
+    destroy();
+    sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    // A fence that was never flushed may never signal for a wait on another context
+    glFlush();
+}
+
+void Fence::gpuWait() {
+    if (!sync) {
+        return;
+    }
+    // Deleting the sync object is deferred by GL until the wait no longer needs it
+    glWaitSync((GLsync)sync, 0, GL_TIMEOUT_IGNORED);
+    destroy();
+}
+
+bool Fence::clientWait(uint64_t timeout) {
+    if (!sync) {
+        return true;
+    }
+    auto result = glClientWaitSync((GLsync)sync, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+    if (result == GL_TIMEOUT_EXPIRED || result == GL_WAIT_FAILED) {
+        return false;
+    }
+    destroy();
+    return true;
+}
+
+void Fence::destroy() {
+    if (sync) {
+        glDeleteSync((GLsync)sync);
+        sync = nullptr;
+    }
+}
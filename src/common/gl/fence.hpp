@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+
+namespace xr_examples { namespace gl {
+
+// Owns a GL fence sync object, for handing work from one context to another without draining the GPU pipeline.  The
+// producing context inserts the fence after the commands the consumer depends on, and the consuming context makes
+// the GPU wait for it, so neither CPU blocks.  Move-only, since a sync object can only be released once, and like the
+// other GL objects here it's only released by `destroy()`, or a wait, with a context current.
+class Fence {
+public:
+    // One second, in nanoseconds
+    static constexpr uint64_t DEFAULT_TIMEOUT = 1000000000;
+
+    Fence() = default;
+    Fence(const Fence&) = delete;
+    Fence& operator=(const Fence&) = delete;
+    Fence(Fence&& other) noexcept;
+    Fence& operator=(Fence&& other) noexcept;
+
+    // Fences the commands issued so far on the current context, replacing any fence still held, and flushes them so
+    // that other contexts can wait on it
+    void insert();
+    // Makes the GPU wait for the fence before executing any commands issued on the current context afterwards, then
+    // releases it.  Doesn't block the CPU, and does nothing if no fence is held
+    void gpuWait();
+    // Blocks the CPU until the fence has signaled, and releases it.  Returns false if it hadn't signaled within
+    // `timeout` nanoseconds, and true if no fence is held
+    bool clientWait(uint64_t timeout = DEFAULT_TIMEOUT);
+    void destroy();
+    explicit operator bool() const { return sync != nullptr; }
+
+private:
+    // GLsync, kept opaque so that this header doesn't need the GL headers
+    void* sync{ nullptr };
+};
+
+}}  // namespace xr_examples::gl
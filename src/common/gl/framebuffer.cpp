@@ -1,6 +1,8 @@
 #define XR_USE_GRAPHICS_API_OPENGL
 #include "framebuffer.hpp"
 
+#include <algorithm>
+
 #include <glad/glad.h>
 
 #include <logging.hpp>
@@ -51,52 +53,230 @@ void FramebufferBase::bind(Target target) {
     glBindFramebuffer(target == Draw ? GL_DRAW_FRAMEBUFFER : GL_READ_FRAMEBUFFER, fbo);
 }
 
+void FramebufferBase::beginRenderPass(const RenderPass& renderPass) {
+    bind();
+    applyLoadOps(fbo, renderPass);
+}
+
+void FramebufferBase::endRenderPass(const RenderPass& renderPass) {
+    applyStoreOps(fbo, renderPass);
+    bindDefault();
+}
+
+void FramebufferBase::setColorAttachment(uint32_t texture) {
+    glNamedFramebufferTexture(fbo, GL_COLOR_ATTACHMENT0, texture, 0);
+    colorAttachment = texture;
+}
+
+void FramebufferBase::setDepthAttachment(uint32_t texture, bool hasStencil) {
+    if (texture == 0) {
+        glNamedFramebufferRenderbuffer(fbo, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthStencil);
+        return;
+    }
+    // Clear both the depth and stencil attachment points first, in case the new depth buffer has no stencil
+    glNamedFramebufferRenderbuffer(fbo, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, 0);
+    glNamedFramebufferTexture(fbo, hasStencil ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT, texture, 0);
+}
+
 void Framebuffer::create(const xr::Extent2Di& size) {
     Parent::create(size);
+    if (!externalColor) {
+        createColor();
+        Parent::setColorAttachment(color);
+    }
+}
+
+void Framebuffer::createColor() {
     glCreateTextures(GL_TEXTURE_2D, 1, &color);
     glTextureStorage2D(color, 1, GL_RGBA8, size.width, size.height);
-    glNamedFramebufferTexture(fbo, GL_COLOR_ATTACHMENT0, color, 0);
+}
+
+void Framebuffer::setColorAttachment(uint32_t texture) {
+    if (texture == 0 && color == 0) {
+        createColor();
+    }
+    Parent::setColorAttachment(texture != 0 ? texture : color);
 }
 
 void Framebuffer::destroy() {
     glDeleteTextures(1, &color);
     color = 0;
+    colorAttachment = 0;
     Parent::destroy();
 }
 
+bool MultiviewFramebuffer::isSupported() {
+    return GLAD_GL_OVR_multiview != 0;
+}
+
+void MultiviewFramebuffer::create(const xr::Extent2Di& size) {
+    this->size = size;
+    this->eyeSize = size;
+    multiview = true;
+
+    glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &color);
+    glTextureStorage3D(color, 1, GL_RGBA8, size.width, size.height, VIEW_COUNT);
+    glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &depthStencil);
+    glTextureStorage3D(depthStencil, 1, GL_DEPTH24_STENCIL8, size.width, size.height, VIEW_COUNT);
+
+    glCreateFramebuffers(1, &fbo);
+    glCreateFramebuffers(VIEW_COUNT, layerFbos.data());
+    attachColor(color);
+    attachDepth(depthStencil, true);
+    checkStatus();
+}
+
+// There's no direct state access version of the multiview attachment functions
+void MultiviewFramebuffer::attachColor(uint32_t texture) {
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo);
+    glFramebufferTextureMultiviewOVR(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, texture, 0, 0, VIEW_COUNT);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    for (uint32_t layer = 0; layer < VIEW_COUNT; ++layer) {
+        glNamedFramebufferTextureLayer(layerFbos[layer], GL_COLOR_ATTACHMENT0, texture, 0, layer);
+    }
+    attachedColor = texture;
+}
+
+void MultiviewFramebuffer::attachDepth(uint32_t texture, bool hasStencil) {
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo);
+    glFramebufferTextureMultiviewOVR(GL_DRAW_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, 0, 0, 0, VIEW_COUNT);
+    glFramebufferTextureMultiviewOVR(GL_DRAW_FRAMEBUFFER, hasStencil ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT,
+                                     texture, 0, 0, VIEW_COUNT);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    attachedDepth = texture;
+}
+
+void MultiviewFramebuffer::setColorAttachment(uint32_t texture) {
+    if (texture == 0) {
+        texture = color;
+    }
+    if (texture != attachedColor) {
+        attachColor(texture);
+    }
+}
+
+void MultiviewFramebuffer::setDepthAttachment(uint32_t texture, bool hasStencil) {
+    if (texture == 0) {
+        texture = depthStencil;
+        hasStencil = true;
+    }
+    if (texture != attachedDepth) {
+        attachDepth(texture, hasStencil);
+    }
+}
+
+void MultiviewFramebuffer::copyTo(uint32_t texture) {
+    glCopyImageSubData(attachedColor, GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0,  //
+                       texture, GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0,        //
+                       size.width, size.height, VIEW_COUNT);
+}
+
+void MultiviewFramebuffer::destroy() {
+    glDeleteFramebuffers(VIEW_COUNT, layerFbos.data());
+    layerFbos = {};
+    glDeleteFramebuffers(1, &fbo);
+    fbo = 0;
+    attachedColor = 0;
+    attachedDepth = 0;
+
+    glDeleteTextures(1, &color);
+    color = 0;
+    glDeleteTextures(1, &depthStencil);
+    depthStencil = 0;
+}
+
+void SwapchainFramebuffer::create(const xr::Extent2Di& size) {
+    this->size = size;
+    this->eyeSize = size;
+    eyeSize.width /= 2;
+    createFramebuffers();
+}
+
+void SwapchainFramebuffer::destroy() {
+    destroyFramebuffers();
+}
+
+void SwapchainFramebuffer::createFramebuffers() {
+    destroyFramebuffers();
+    if (images.empty()) {
+        return;
+    }
+
+    // Without a depth swapchain every FBO shares one depth buffer, which is only ever used by one frame at a time
+    if (depthImages.empty()) {
+        glCreateRenderbuffers(1, &depthStencil);
+        glNamedRenderbufferStorage(depthStencil, GL_DEPTH24_STENCIL8, size.width, size.height);
+    }
+
+    auto depthCount = std::max<size_t>(depthImages.size(), 1);
+    fbos.resize(images.size() * depthCount);
+    glCreateFramebuffers((GLsizei)fbos.size(), fbos.data());
+    for (size_t i = 0; i < fbos.size(); ++i) {
+        fbo = fbos[i];
+        glNamedFramebufferTexture(fbo, GL_COLOR_ATTACHMENT0, images[i / depthCount].image, 0);
+        if (depthImages.empty()) {
+            glNamedFramebufferRenderbuffer(fbo, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthStencil);
+        } else {
+            auto attachment = depthHasStencil ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+            glNamedFramebufferTexture(fbo, attachment, depthImages[i % depthCount].image, 0);
+        }
+        checkStatus();
+    }
+    fbo = fbos[0];
+}
+
+void SwapchainFramebuffer::destroyFramebuffers() {
+    if (!fbos.empty()) {
+        glDeleteFramebuffers((GLsizei)fbos.size(), fbos.data());
+        fbos.clear();
+    }
+    fbo = 0;
+
+    if (depthStencil != 0) {
+        glDeleteRenderbuffers(1, &depthStencil);
+        depthStencil = 0;
+    }
+}
+
 void SwapchainFramebuffer::setSwapchain(const xr::Swapchain& swapchain) {
     this->swapchain = swapchain;
     this->images = swapchain.enumerateSwapchainImages<xr::SwapchainImageOpenGLKHR>();
+    if (!fbos.empty()) {
+        createFramebuffers();
+    }
 }
 
-void SwapchainFramebuffer::setDepthSwapchain(const xr::Swapchain& swapchain) {
+void SwapchainFramebuffer::setDepthSwapchain(const xr::Swapchain& swapchain, bool hasStencil) {
     this->depthSwapchain = swapchain;
     this->depthImages = swapchain.enumerateSwapchainImages<xr::SwapchainImageOpenGLKHR>();
+    this->depthHasStencil = hasStencil;
+    if (!fbos.empty()) {
+        createFramebuffers();
+    }
 }
 
-void SwapchainFramebuffer::bind(Target target) {
+void SwapchainFramebuffer::acquire() {
     if (!valid) {
-        {
-            auto swapchainIndex = swapchain.acquireSwapchainImage({});
-            const auto& image = images[swapchainIndex];
-            swapchain.waitSwapchainImage({ xr::Duration::infinite() });
-            glNamedFramebufferTexture(fbo, GL_COLOR_ATTACHMENT0, image.image, 0);
-        }
+        colorIndex = swapchain.acquireSwapchainImage({});
+        swapchain.waitSwapchainImage({ xr::Duration::infinite() });
         if (depthSwapchain) {
-            auto depthSwapchainIndex = depthSwapchain.acquireSwapchainImage({});
-            const auto& depthImage = depthImages[depthSwapchainIndex];
+            depthIndex = depthSwapchain.acquireSwapchainImage({});
             depthSwapchain.waitSwapchainImage({ xr::Duration::infinite() });
-            glNamedFramebufferTexture(fbo, GL_DEPTH_STENCIL_ATTACHMENT, depthImage.image, 0);
+        }
+        if (!fbos.empty()) {
+            fbo = fbos[colorIndex * std::max<size_t>(depthImages.size(), 1) + depthIndex];
         }
         valid = true;
     }
+}
+
+void SwapchainFramebuffer::bind(Target target) {
+    acquire();
     Parent::bind(target);
 }
 
 void SwapchainFramebuffer::advance() {
-    glNamedFramebufferTexture(fbo, GL_COLOR_ATTACHMENT0, 0, 0);
     if (depthSwapchain) {
-        glNamedFramebufferTexture(fbo, GL_DEPTH_STENCIL_ATTACHMENT, 0, 0);
         depthSwapchain.releaseSwapchainImage({});
     }
     swapchain.releaseSwapchainImage({});
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+
 #include <interfaces.hpp>
 
 namespace xr_examples { namespace gl {
@@ -15,11 +17,19 @@ public:
     void setViewport(const xr::Rect2Di& vp) override;
     void checkStatus(Target target = Draw);
     void bind(Target target = Draw) override;
+    void beginRenderPass(const RenderPass& renderPass) override;
+    void endRenderPass(const RenderPass& renderPass) override;
+    void setColorAttachment(uint32_t texture) override;
+    void setDepthAttachment(uint32_t texture, bool hasStencil = true) override;
+    uint32_t getColorTexture() const override { return colorAttachment; }
 
     inline uint32_t id() override { return fbo; }
 
     uint32_t fbo{ 0 };
     uint32_t depthStencil{ 0 };
+
+protected:
+    uint32_t colorAttachment{ 0 };
 };
 
 class Framebuffer : public FramebufferBase {
@@ -28,16 +38,68 @@ class Framebuffer : public FramebufferBase {
 public:
     void create(const xr::Extent2Di& size) override;
     void destroy() override;
+    void setColorAttachment(uint32_t texture) override;
 
+    // Zero until allocated, see `setExternalColor()`
     uint32_t color{ 0 };
+
+private:
+    void createColor();
 };
 
+// A pair of texture array layers, one per eye, that both eyes render to with a single set of draws via
+// GL_OVR_multiview.  The size passed to `create()` is the size of each layer.
+class MultiviewFramebuffer : public FramebufferBase {
+    using Parent = FramebufferBase;
+
+public:
+    static constexpr uint32_t VIEW_COUNT = 2;
+
+    // Requires a current context with the GL functions loaded
+    static bool isSupported();
+
+    void create(const xr::Extent2Di& size) override;
+    void destroy() override;
+    // `texture` must be a 2D array texture with at least `VIEW_COUNT` layers, e.g. an array swapchain image
+    void setColorAttachment(uint32_t texture) override;
+    void setDepthAttachment(uint32_t texture, bool hasStencil = true) override;
+    uint32_t getColorTexture() const override { return attachedColor; }
+    // A regular framebuffer over a single layer of the current color attachment, for blitting from
+    uint32_t getLayerFramebuffer(uint32_t layer) const { return layerFbos[layer]; }
+    // Copies both layers of the color attachment into the matching layers of a 2D array texture
+    void copyTo(uint32_t texture);
+
+    uint32_t color{ 0 };
+
+private:
+    void attachColor(uint32_t texture);
+    void attachDepth(uint32_t texture, bool hasStencil);
+
+    std::array<uint32_t, VIEW_COUNT> layerFbos{};
+    uint32_t attachedColor{ 0 };
+    uint32_t attachedDepth{ 0 };
+};
+
+// Renders to the images of an OpenXR swapchain, and optionally a depth swapchain.  Rather than re-attaching the
+// acquired images to a single FBO every frame, which makes the driver revalidate it, one FBO is built up front for
+// every combination of color and depth image index, and binding just selects the one for the acquired indices.
+// Framebuffer objects aren't shared between contexts, so they are built by `create()`, on the context that renders.
 class SwapchainFramebuffer : public FramebufferBase {
     using Parent = FramebufferBase;
 
 public:
+    void create(const xr::Extent2Di& size) override;
+    void destroy() override;
     void setSwapchain(const xr::Swapchain& swapchain);
-    void setDepthSwapchain(const xr::Swapchain& swapchain);
+    // `hasStencil` is whether the format of the depth swapchain has a stencil component
+    void setDepthSwapchain(const xr::Swapchain& swapchain, bool hasStencil = true);
+    // Acquires and waits on the next swapchain image(s), unless that has already been done since the last `advance()`.
+    // A swapchain that's only ever written with `getColorImage()` doesn't need to be `create()`d
+    void acquire();
+    // The acquired images, only valid between `acquire()` and `advance()`
+    uint32_t getColorImage() const { return images[colorIndex].image; }
+    uint32_t getDepthImage() const { return depthImages[depthIndex].image; }
+    uint32_t getColorTexture() const override { return getColorImage(); }
     void bind(Target target = Draw) override;
     void advance();
 
@@ -45,7 +107,16 @@ public:
     std::vector<xr::SwapchainImageOpenGLKHR> images;
     xr::Swapchain depthSwapchain;
     std::vector<xr::SwapchainImageOpenGLKHR> depthImages;
+    bool depthHasStencil{ true };
+    // Indexed by `colorIndex * max(depthImages.size(), 1) + depthIndex`.  `fbo` is always one of these
+    std::vector<uint32_t> fbos;
+    uint32_t colorIndex{ 0 };
+    uint32_t depthIndex{ 0 };
     bool valid{ false };
+
+private:
+    void createFramebuffers();
+    void destroyFramebuffers();
 };
 
 }}  // namespace xr_examples::gl
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <interfaces.hpp>
+
+namespace xr_examples { namespace gl {
+
+inline glm::vec3 toGlm(const xr::Vector3f& v) {
+    return glm::make_vec3(&v.x);
+}
+
+inline glm::quat toGlm(const xr::Quaternionf& q) {
+    return glm::make_quat(&q.x);
+}
+
+inline glm::mat4 toGlm(const xr::Fovf& fov, float nearZ = 0.01f, float farZ = 1000.0f) {
+    auto tanAngleRight = tanf(fov.angleRight);
+    auto tanAngleLeft = tanf(fov.angleLeft);
+    auto tanAngleUp = tanf(fov.angleUp);
+    auto tanAngleDown = tanf(fov.angleDown);
+    const float tanAngleWidth = tanAngleRight - tanAngleLeft;
+    const float tanAngleHeight = tanAngleUp - tanAngleDown;
+
+    glm::mat4 result{ 0.0f };
+    result[0][0] = 2 / tanAngleWidth;
+    result[2][0] = (tanAngleRight + tanAngleLeft) / tanAngleWidth;
+    result[1][1] = 2 / tanAngleHeight;
+    result[2][1] = (tanAngleUp + tanAngleDown) / tanAngleHeight;
+    result[2][2] = -(farZ + nearZ) / (farZ - nearZ);
+    result[3][2] = -(farZ * (nearZ + nearZ)) / (farZ - nearZ);
+    result[2][3] = -1;
+    return result;
+}
+
+inline glm::mat4 toGlm(const xr::Posef& p) {
+    glm::mat4 orientation = glm::mat4_cast(toGlm(p.orientation));
+    glm::mat4 translation = glm::translate(glm::mat4{ 1 }, toGlm(p.position));
+    return translation * orientation;
+}
+
+}}  // namespace xr_examples::gl
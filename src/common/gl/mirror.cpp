@@ -0,0 +1,268 @@
+#include "mirror.hpp"
+
+#include <array>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include <glad/glad.h>
+
+#include <assets.hpp>
+#include <logging.hpp>
+#include <gl/debug.hpp>
+#include <gl/fence.hpp>
+#include <gl/pipeline.hpp>
+
+using namespace xr_examples;
+using namespace xr_examples::gl;
+
+struct Mirror::Private {
+    using Lock = std::unique_lock<std::mutex>;
+
+    // One intermediate can be presented by the mirror thread while the other is drawn
+    static constexpr uint32_t BUFFERS = 2;
+    static constexpr int32_t NONE = -1;
+
+    // Uniform locations of the mirror shaders
+    static constexpr int32_t SOURCE_RECT_LOCATION = 0;
+    static constexpr int32_t TAP_OFFSET_LOCATION = 1;
+    static constexpr int32_t LAYER_LOCATION = 2;
+
+    Private(Window& window, bool async) : window(window), size(window.getSize()) {
+        auto vertexShader = assets::getAssetContents("shaders/mirror.vert.glsl");
+        auto fragmentShader = assets::getAssetContents("shaders/mirror.frag.glsl");
+        pipeline.addShaderSources(ShaderStage::eVertex, vertexShader);
+        pipeline.addShaderSources(ShaderStage::eFragment, fragmentShader);
+        pipeline.create();
+        layeredPipeline.addShaderSources(ShaderStage::eVertex, vertexShader);
+        layeredPipeline.addShaderSources(ShaderStage::eFragment, Pipeline::withDefine(fragmentShader, "LAYERED"));
+        layeredPipeline.create();
+
+        // Swapchain images come with whatever sampling state the runtime left them in, which may need mipmaps
+        glCreateSamplers(1, &sampler);
+        glSamplerParameteri(sampler, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glSamplerParameteri(sampler, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glSamplerParameteri(sampler, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glSamplerParameteri(sampler, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+        glCreateTextures(GL_TEXTURE_2D, BUFFERS, textures.data());
+        glCreateFramebuffers(BUFFERS, fbos.data());
+        for (uint32_t i = 0; i < BUFFERS; ++i) {
+            glTextureStorage2D(textures[i], 1, GL_RGBA8, size.width, size.height);
+            glNamedFramebufferTexture(fbos[i], GL_COLOR_ATTACHMENT0, textures[i], 0);
+        }
+
+        if (async) {
+            startThread();
+        }
+    }
+
+    ~Private() { stopThread(); }
+
+    void startThread() {
+        // The thread's context has to see the intermediates before it can attach them to its own framebuffers
+        ready.insert();
+        context = window.createOffscreenContext();
+        if (context && context->canPresent()) {
+            context->doneCurrent();
+            thread = std::thread([this] { run(); });
+        } else {
+            if (context) {
+                context->destroy();
+                context.reset();
+            }
+            ready.destroy();
+            logging::log(logging::Level::Warning,
+                         "The window can't be presented to from another thread, mirroring synchronously");
+        }
+        // Creating the offscreen context may have made it current
+        window.makeCurrent();
+    }
+
+    void stopThread() {
+        if (!thread.joinable()) {
+            return;
+        }
+        {
+            Lock lock{ mutex };
+            quit = true;
+            conditional.notify_one();
+        }
+        thread.join();
+    }
+
+    void destroy() {
+        stopThread();
+        for (auto& fence : fences) {
+            fence.destroy();
+        }
+        glDeleteFramebuffers(BUFFERS, fbos.data());
+        glDeleteTextures(BUFFERS, textures.data());
+        glDeleteSamplers(1, &sampler);
+        pipeline.destroy();
+        layeredPipeline.destroy();
+    }
+
+    // Picks an intermediate the mirror thread isn't presenting, and withdraws it if it was waiting to be presented
+    uint32_t beginUpdate() {
+        if (!thread.joinable()) {
+            return 0;
+        }
+        Lock lock{ mutex };
+        auto index = presenting == 0 ? 1u : 0u;
+        if (pending == (int32_t)index) {
+            pending = NONE;
+            fences[index].destroy();
+        }
+        return index;
+    }
+
+    void endUpdate(uint32_t index) {
+        latest = (int32_t)index;
+        if (!thread.joinable()) {
+            return;
+        }
+        Fence fence;
+        fence.insert();
+        Lock lock{ mutex };
+        fences[index] = std::move(fence);
+        pending = (int32_t)index;
+        conditional.notify_one();
+    }
+
+    void update(Framebuffer& source, Mode mode) {
+        auto index = beginUpdate();
+        const auto& sourceSize = source.getSize();
+        auto& activePipeline = source.isMultiview() ? layeredPipeline : pipeline;
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbos[index]);
+        activePipeline.bind();
+        glBindTextureUnit(0, source.getColorTexture());
+        glBindSampler(0, sampler);
+        uint32_t eyeCount = mode == Mode::LeftEye ? 1 : 2;
+        for (uint32_t eyeIndex = 0; eyeIndex < eyeCount; ++eyeIndex) {
+            xr::Rect2Di destRect{ { 0, 0 }, { size.width / (int32_t)eyeCount, size.height } };
+            destRect.offset.x = destRect.extent.width * (int32_t)eyeIndex;
+            glViewport(destRect.offset.x, destRect.offset.y, destRect.extent.width, destRect.extent.height);
+
+            auto sourceRect = source.getViewportSide(eyeIndex);
+            float u = (float)sourceRect.offset.x / (float)sourceSize.width;
+            float v = (float)sourceRect.offset.y / (float)sourceSize.height;
+            float width = (float)sourceRect.extent.width / (float)sourceSize.width;
+            float height = (float)sourceRect.extent.height / (float)sourceSize.height;
+            glProgramUniform4f(activePipeline.program, SOURCE_RECT_LOCATION, u, v, width, height);
+            glProgramUniform2f(activePipeline.program, TAP_OFFSET_LOCATION, 0.25f * width / (float)destRect.extent.width,
+                               0.25f * height / (float)destRect.extent.height);
+            if (source.isMultiview()) {
+                glProgramUniform1f(activePipeline.program, LAYER_LOCATION, (float)eyeIndex);
+            }
+            glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        }
+        glBindSampler(0, 0);
+        glBindTextureUnit(0, 0);
+        glBindVertexArray(0);
+        glUseProgram(0);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+        endUpdate(index);
+    }
+
+    void present() {
+        if (thread.joinable()) {
+            return;
+        }
+        if (latest != NONE) {
+            blitToWindow(fbos[latest]);
+        }
+        window.swapBuffers();
+    }
+
+    void blitToWindow(uint32_t fbo) {
+        glBlitNamedFramebuffer(fbo, 0, 0, 0, size.width, size.height, 0, 0, size.width, size.height, GL_COLOR_BUFFER_BIT,
+                               GL_NEAREST);
+    }
+
+    // The mirror thread.  Framebuffer objects aren't shared between contexts, so it has its own over the intermediates
+    void run() {
+        context->makeCurrent();
+        gl::enableDebugLogging();
+        ready.gpuWait();
+        std::array<uint32_t, BUFFERS> threadFbos{};
+        glCreateFramebuffers(BUFFERS, threadFbos.data());
+        for (uint32_t i = 0; i < BUFFERS; ++i) {
+            glNamedFramebufferTexture(threadFbos[i], GL_COLOR_ATTACHMENT0, textures[i], 0);
+        }
+
+        using namespace std::chrono_literals;
+        while (true) {
+            Fence fence;
+            {
+                Lock lock{ mutex };
+                presenting = NONE;
+                if (!conditional.wait_for(lock, 100ms, [this] { return quit || pending != NONE; })) {
+                    continue;
+                }
+                if (quit) {
+                    break;
+                }
+                presenting = pending;
+                pending = NONE;
+                fence = std::move(fences[presenting]);
+            }
+            fence.gpuWait();
+            blitToWindow(threadFbos[presenting]);
+            context->present();
+        }
+
+        glDeleteFramebuffers(BUFFERS, threadFbos.data());
+        context->doneCurrent();
+        context->destroy();
+    }
+
+    Window& window;
+    const xr::Extent2Di size;
+    Pipeline pipeline;
+    Pipeline layeredPipeline;
+    uint32_t sampler{ 0 };
+    std::array<uint32_t, BUFFERS> textures{};
+    std::array<uint32_t, BUFFERS> fbos{};
+    // The intermediate last drawn, for presenting synchronously
+    int32_t latest{ NONE };
+
+    Context::Pointer context;
+    // Fenced on the window's context once the intermediates are created, and waited on by the mirror thread
+    Fence ready;
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable conditional;
+    // Guarded by `mutex`
+    std::array<Fence, BUFFERS> fences;
+    int32_t pending{ NONE };
+    int32_t presenting{ NONE };
+    bool quit{ false };
+};
+
+void Mirror::create(Window& window, bool async) {
+    d = std::make_shared<Private>(window, async);
+}
+
+void Mirror::destroy() {
+    if (d) {
+        d->destroy();
+        d.reset();
+    }
+}
+
+bool Mirror::isAsync() const {
+    return d && d->thread.joinable();
+}
+
+void Mirror::update(Framebuffer& source, Mode mode) {
+    if (d && mode != Mode::Off) {
+        d->update(source, mode);
+    }
+}
+
+void Mirror::present() {
+    if (d) {
+        d->present();
+    }
+}
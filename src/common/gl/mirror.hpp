@@ -0,0 +1,43 @@
+#pragma once
+
+#include <memory>
+
+#include <interfaces.hpp>
+
+namespace xr_examples { namespace gl {
+
+// Draws the scene layer to the desktop window.  Instead of blitting the full size scene framebuffer to the window,
+// the eye(s) are downscaled with a cheap shader pass into an intermediate texture the size of the window, and that
+// is what gets presented.
+//
+// If it's created `async`, and the window can create an offscreen context that presents to it (see
+// `Context::canPresent()`), the intermediate is presented from a thread of its own, so a blocking swap never holds
+// up the XR frame loop.  The frame loop hands each intermediate over with a fence and never waits on the thread; if
+// the thread is still presenting when the next mirror frame is ready, the older of the two unpresented ones is
+// dropped.
+class Mirror {
+    struct Private;
+
+public:
+    enum class Mode
+    {
+        Off,
+        LeftEye,
+        BothEyes,
+    };
+
+    // Must be called with the window's context current
+    void create(Window& window, bool async);
+    void destroy();
+    bool isAsync() const;
+    // Downscales the current color texture of `source` into the intermediate, on the current context, and hands it
+    // to the mirror thread if there is one
+    void update(Framebuffer& source, Mode mode);
+    // Presents the most recent intermediate to the window, unless the mirror thread does that
+    void present();
+
+private:
+    std::shared_ptr<Private> d;
+};
+
+}}  // namespace xr_examples::gl
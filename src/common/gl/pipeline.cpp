@@ -3,6 +3,11 @@
 
 using namespace xr_examples::gl;
 
+std::string Pipeline::withDefine(const std::string& source, const std::string& define) {
+    auto lineEnd = source.find('\n') + 1;
+    return source.substr(0, lineEnd) + "#define " + define + "\n" + source.substr(lineEnd);
+}
+
 void Pipeline::addShaderSources(ShaderStage stage, const StringArrayProxy& newShaderSources) {
     auto& list = shaderSources[stage];
     for (const auto& shaderSource : newShaderSources) {
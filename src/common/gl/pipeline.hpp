@@ -24,6 +24,9 @@ struct AttributeFormat {
 };
 
 struct Pipeline {
+    // Defines must follow the `#version` directive on the first line of the shader
+    static std::string withDefine(const std::string& source, const std::string& define);
+
     void addShaderSources(ShaderStage stage, const StringArrayProxy& newShaderSources);
     void setAttributeFormat(uint32_t location, const AttributeFormat& formatType);
     void setAttributeFormat(uint32_t location, AttributeFormat::Type formatType, uint32_t size, uint32_t scalarType, uint32_t offset = 0);
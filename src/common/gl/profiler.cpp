@@ -0,0 +1,135 @@
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include <glad/glad.h>
+#include <logging.hpp>
+
+namespace xr_examples { namespace gl {
+
+Profiler::Zone* Profiler::findZone(const std::string& name) const {
+    for (const auto& zone : zones) {
+        if (zone->name == name) {
+            return zone.get();
+        }
+    }
+    return nullptr;
+}
+
+Profiler::Zone& Profiler::getZone(const char* name) {
+    // Only the owning thread ever adds zones, so looking them up here doesn't need the lock
+    for (const auto& zone : zones) {
+        if (0 == strcmp(zone->name.c_str(), name)) {
+            // Recreate the queries of a zone reused after destroy()
+            if (0 == zone->queries[0]) {
+                glGenQueries((GLsizei)zone->queries.size(), zone->queries.data());
+            }
+            return *zone;
+        }
+    }
+
+    auto zone = std::make_unique<Zone>();
+    zone->name = name;
+    glGenQueries((GLsizei)zone->queries.size(), zone->queries.data());
+    std::unique_lock<std::mutex> lock(mutex);
+    zones.push_back(std::move(zone));
+    return *zones.back();
+}
+
+void Profiler::collectResults(Zone& zone) {
+    // Oldest first, so the newest available result is the one reported as `last`
+    for (uint32_t i = 0; i < FRAMES; ++i) {
+        auto index = (zone.next + i) % FRAMES;
+        if (!zone.pending[index]) {
+            continue;
+        }
+        // Timestamps complete in order, so if the end of the zone is available so is the start
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(zone.queries[index * 2 + 1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (GL_FALSE == available) {
+            continue;
+        }
+        GLuint64 start = 0, end = 0;
+        glGetQueryObjectui64v(zone.queries[index * 2], GL_QUERY_RESULT, &start);
+        glGetQueryObjectui64v(zone.queries[index * 2 + 1], GL_QUERY_RESULT, &end);
+        zone.pending[index] = false;
+
+        auto milliseconds = (float)(end - start) / 1.0e6f;
+        std::unique_lock<std::mutex> lock(mutex);
+        auto& result = zone.result;
+        result.last = milliseconds;
+        result.min = result.samples == 0 ? milliseconds : std::min(result.min, milliseconds);
+        result.max = result.samples == 0 ? milliseconds : std::max(result.max, milliseconds);
+        result.avg += (milliseconds - result.avg) / (float)(result.samples + 1);
+        ++result.samples;
+        zone.hasNewResult = true;
+    }
+}
+
+void Profiler::beginZone(const char* name) {
+    assert(depth < MAX_DEPTH);
+    auto& zone = getZone(name);
+    collectResults(zone);
+    openZones[depth++] = &zone;
+    zone.pending[zone.next] = false;
+    glQueryCounter(zone.queries[zone.next * 2], GL_TIMESTAMP);
+}
+
+void Profiler::endZone() {
+    assert(depth > 0);
+    auto& zone = *openZones[--depth];
+    glQueryCounter(zone.queries[zone.next * 2 + 1], GL_TIMESTAMP);
+    zone.pending[zone.next] = true;
+    zone.next = (zone.next + 1) % FRAMES;
+}
+
+void Profiler::destroy() {
+    std::unique_lock<std::mutex> lock(mutex);
+    // Keep the zones and their accumulated results so they can still be reported once the queries are gone
+    for (auto& zone : zones) {
+        if (0 != zone->queries[0]) {
+            glDeleteQueries((GLsizei)zone->queries.size(), zone->queries.data());
+        }
+        zone->queries.fill(0);
+        zone->pending.fill(false);
+        zone->next = 0;
+    }
+    depth = 0;
+}
+
+bool Profiler::popZoneTime(const std::string& name, float& milliseconds) {
+    std::unique_lock<std::mutex> lock(mutex);
+    auto zone = findZone(name);
+    if (!zone || !zone->hasNewResult) {
+        return false;
+    }
+    milliseconds = zone->result.last;
+    zone->hasNewResult = false;
+    return true;
+}
+
+bool Profiler::getZoneResult(const std::string& name, ZoneResult& result) const {
+    std::unique_lock<std::mutex> lock(mutex);
+    auto zone = findZone(name);
+    if (!zone || 0 == zone->result.samples) {
+        return false;
+    }
+    result = zone->result;
+    return true;
+}
+
+void Profiler::logSummary(const std::string& label) const {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (const auto& zone : zones) {
+        const auto& result = zone->result;
+        if (0 == result.samples) {
+            continue;
+        }
+        LOG_INFO("{} {:<20} min {:.3f} ms, avg {:.3f} ms, max {:.3f} ms over {} samples", label, zone->name, result.min,
+                 result.avg, result.max, result.samples);
+    }
+}
+
+}}  // namespace xr_examples::gl
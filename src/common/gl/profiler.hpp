@@ -0,0 +1,84 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace xr_examples { namespace gl {
+
+// Names of the zones timed by the example framework
+namespace zone {
+static const char* const SCENE = "scene";
+static const char* const FOVEATED_INSET = "foveatedInset";
+static const char* const BLIT_TO_PROJECTION = "blitToProjection";
+static const char* const EXTRA_LAYERS = "extraLayers";
+static const char* const UI_LAYER = "uiLayer";
+static const char* const MIRROR_BLIT = "mirrorBlit";
+}  // namespace zone
+
+// GPU profiler built on GL_TIMESTAMP queries.  Every named zone owns a ring of query pairs `FRAMES` deep, and a
+// zone's previous results are only read back when they are available, so profiling never stalls the CPU waiting
+// on the GPU.  If a result still isn't available by the time its queries come around again it is dropped.
+//
+// Query objects aren't shared between GL contexts, so each context that issues zones needs its own profiler.  The
+// queries for a zone are created the first time it is used, on the context current at the time, and the zone must
+// always be issued on that context afterwards.  Results may be read from any thread.
+class Profiler {
+public:
+    static constexpr uint32_t FRAMES = 4;
+    static constexpr uint32_t MAX_DEPTH = 8;
+
+    // All times in milliseconds
+    struct ZoneResult {
+        float last{ 0.0f };
+        float min{ 0.0f };
+        float max{ 0.0f };
+        float avg{ 0.0f };
+        uint32_t samples{ 0 };
+    };
+
+    class ScopedZone {
+    public:
+        ScopedZone(Profiler& profiler, const char* name) : profiler(profiler) { profiler.beginZone(name); }
+        ~ScopedZone() { profiler.endZone(); }
+
+    private:
+        Profiler& profiler;
+    };
+
+    // Zones may nest, up to MAX_DEPTH deep
+    void beginZone(const char* name);
+    void endZone();
+    ScopedZone zone(const char* name) { return ScopedZone(*this, name); }
+    // Releases the query objects but keeps the results.  Must be called on the context(s) the zones were issued on
+    void destroy();
+
+    // Returns true and the latest time of the zone if a new result has arrived since the last call
+    bool popZoneTime(const std::string& name, float& milliseconds);
+    bool getZoneResult(const std::string& name, ZoneResult& result) const;
+    void logSummary(const std::string& label) const;
+
+private:
+    struct Zone {
+        std::string name;
+        std::array<uint32_t, FRAMES * 2> queries{};
+        std::array<bool, FRAMES> pending{};
+        uint32_t next{ 0 };
+        ZoneResult result;
+        bool hasNewResult{ false };
+    };
+
+    Zone& getZone(const char* name);
+    Zone* findZone(const std::string& name) const;
+    void collectResults(Zone& zone);
+
+    std::vector<std::unique_ptr<Zone>> zones;
+    std::array<Zone*, MAX_DEPTH> openZones{};
+    uint32_t depth{ 0 };
+    mutable std::mutex mutex;
+};
+
+}}  // namespace xr_examples::gl
@@ -0,0 +1,153 @@
+#include "renderWorkerPool.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gl/debug.hpp>
+#include <gl/fence.hpp>
+
+using namespace xr_examples;
+using namespace xr_examples::gl;
+
+namespace {
+
+struct Worker {
+    using Lock = std::unique_lock<std::mutex>;
+
+    Worker(const Window& window) {
+        // Anything the window's context has created has to be visible to the new context before a layer uses it there
+        ready.insert();
+        context = window.createOffscreenContext();
+        if (!context) {
+            ready.destroy();
+            throw std::runtime_error("The window can't create offscreen contexts for render workers");
+        }
+        context->doneCurrent();
+        thread = std::thread([this] { run(); });
+        // Creating the offscreen context may have made it current
+        window.makeCurrent();
+    }
+
+    ~Worker() {
+        {
+            Lock lock{ mutex };
+            quit = true;
+        }
+        conditional.notify_one();
+        thread.join();
+    }
+
+    void submit(RenderWorkerPool::Job&& job) {
+        {
+            Lock lock{ mutex };
+            jobs.push_back(std::move(job));
+        }
+        conditional.notify_one();
+    }
+
+    void run() {
+        context->makeCurrent();
+        gl::enableDebugLogging();
+        ready.gpuWait();
+        while (true) {
+            RenderWorkerPool::Job job;
+            {
+                Lock lock{ mutex };
+                conditional.wait(lock, [this] { return quit || !jobs.empty(); });
+                // Jobs submitted before quitting still run, a layer may be waiting on one to release its resources
+                if (jobs.empty()) {
+                    break;
+                }
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+            job();
+        }
+        context->doneCurrent();
+        context->destroy();
+    }
+
+    Context::Pointer context;
+    // Fenced on the window's context before the worker's is created, and waited on by the worker
+    Fence ready;
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable conditional;
+    // Guarded by `mutex`
+    std::deque<RenderWorkerPool::Job> jobs;
+    bool quit{ false };
+    // Only touched on the window's thread
+    uint32_t layers{ 0 };
+};
+
+}  // namespace
+
+struct RenderWorkerPool::Private {
+    Private(const Window& window, uint32_t workerCount) : window(window), workerCount(workerCount) {}
+
+    uint32_t acquireWorker() {
+        if (workers.size() < workerCount) {
+            workers.push_back(std::make_unique<Worker>(window));
+        }
+        auto leastBusy = std::min_element(workers.begin(), workers.end(),
+                                          [](const auto& a, const auto& b) { return a->layers < b->layers; });
+        ++(*leastBusy)->layers;
+        return (uint32_t)(leastBusy - workers.begin());
+    }
+
+    Worker& getWorker(uint32_t worker) {
+        if (worker >= workers.size()) {
+            throw std::runtime_error("Invalid render worker");
+        }
+        return *workers[worker];
+    }
+
+    const Window& window;
+    const uint32_t workerCount;
+    std::vector<std::unique_ptr<Worker>> workers;
+};
+
+void RenderWorkerPool::create(const Window& window, uint32_t workerCount) {
+    d = std::make_shared<Private>(window, std::clamp<uint32_t>(workerCount, 1, MAX_WORKERS));
+}
+
+void RenderWorkerPool::destroy() {
+    d.reset();
+}
+
+uint32_t RenderWorkerPool::acquireWorker() {
+    if (!d) {
+        throw std::runtime_error("Render worker pool not created");
+    }
+    return d->acquireWorker();
+}
+
+void RenderWorkerPool::releaseWorker(uint32_t worker) {
+    if (d) {
+        --d->getWorker(worker).layers;
+    }
+}
+
+void RenderWorkerPool::submit(uint32_t worker, Job&& job) {
+    d->getWorker(worker).submit(std::move(job));
+}
+
+void RenderWorkerPool::run(uint32_t worker, Job&& job) {
+    std::promise<void> done;
+    auto future = done.get_future();
+    submit(worker, [&] {
+        job();
+        done.set_value();
+    });
+    future.wait();
+}
+
+uint32_t RenderWorkerPool::getRunningWorkers() const {
+    return d ? (uint32_t)d->workers.size() : 0;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+
+#include <interfaces.hpp>
+
+namespace xr_examples { namespace gl {
+
+// A small, fixed number of render threads, each with an offscreen GL context of its own shared with the window's,
+// that offscreen layers (see `ThreadedSwapchainRenderer`) run their rendering on, instead of a thread and context
+// per layer.  GL objects that aren't shared between contexts, like framebuffers and queries, tie a layer to the
+// worker that created them, so each layer is pinned to one worker for its lifetime.  Workers are started lazily, the
+// first time a layer is pinned to them, up to the count given to `create()`, and run their jobs in submission order.
+class RenderWorkerPool {
+    struct Private;
+
+public:
+    using Job = std::function<void()>;
+    static constexpr uint32_t MAX_WORKERS = 8;
+
+    // Must be called on the window's thread, as must `acquireWorker()`.  `workerCount` is clamped to
+    // [1, MAX_WORKERS]
+    void create(const Window& window, uint32_t workerCount);
+    // Runs the jobs already submitted, then joins the workers
+    void destroy();
+    // Pins a new layer to a worker: a new one while fewer than `workerCount` are running, otherwise the one with the
+    // fewest layers
+    uint32_t acquireWorker();
+    void releaseWorker(uint32_t worker);
+    // Runs the job on the worker's thread, with its context current
+    void submit(uint32_t worker, Job&& job);
+    // Like `submit()`, but waits for the job to have run.  Must not be called from a worker
+    void run(uint32_t worker, Job&& job);
+    uint32_t getRunningWorkers() const;
+
+private:
+    std::shared_ptr<Private> d;
+};
+
+}}  // namespace xr_examples::gl
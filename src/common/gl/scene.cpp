@@ -1,34 +1,109 @@
 #include "scene.hpp"
 
+#include <algorithm>
+#include <string>
+#include <vector>
+
 #include <openxr/openxr.hpp>
 
+#include <glad/glad.h>
+
 #include <basis.hpp>
 #include <assets.hpp>
 
-#include <magnum/math.hpp>
+#include <gl/pipeline.hpp>
 
 using namespace xr_examples::gl;
 
+// The eye view matrices are read from the `EyeViews` uniform block, which the caller binds before rendering, see
+// `gl::EyeViewsUniformBuffer`
 struct Scene::Private {
     using EyeStates = xr_examples::EyeStates;
     using HandStates = xr_examples::HandStates;
 
-    Private() {}
+    // Location of the `eyeIndex` uniform in the single view skybox shader
+    static constexpr int32_t EYE_INDEX_LOCATION = 0;
+
+    Private() {
+        auto vertexShader = assets::getAssetContents("shaders/skybox.vert.glsl");
+        auto fragmentShader = assets::getAssetContents("shaders/skybox.frag.glsl");
+        skybox.addShaderSources(ShaderStage::eVertex, vertexShader);
+        skybox.addShaderSources(ShaderStage::eFragment, fragmentShader);
+        skybox.create();
+        // Only built the first time it's used, since it won't compile without GL_OVR_multiview
+        multiviewSkybox.addShaderSources(ShaderStage::eVertex, Pipeline::withDefine(vertexShader, "MULTIVIEW"));
+        multiviewSkybox.addShaderSources(ShaderStage::eFragment, fragmentShader);
+    }
 
-    ~Private() {}
+    ~Private() {
+        skybox.destroy();
+        multiviewSkybox.destroy();
+        glDeleteTextures(1, &cubemap);
+    }
 
     void loadCubemap(const std::string& filename) {
+        auto buffer = assets::getAssetContentsBinary(filename);
+        BasisReader basisReader{ buffer.data(), buffer.size() };
+        const auto& ii = basisReader.imageInfo;
+        GLsizei width = ii.m_orig_width, height = ii.m_orig_height;
+
+        glDeleteTextures(1, &cubemap);
+        glCreateTextures(GL_TEXTURE_CUBE_MAP, 1, &cubemap);
+        GLsizei levels = 1;
+        while ((std::min(width, height) >> levels) != 0) {
+            ++levels;
+        }
+        glTextureStorage2D(cubemap, levels, GL_RGBA8, width, height);
+        glTextureParameteri(cubemap, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTextureParameteri(cubemap, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+        std::vector<uint8_t> imageBuffer;
+        imageBuffer.resize(basisReader.getImageSize());
+        for (uint32_t face = 0; face < 6; ++face) {
+            basisReader.readImageToBuffer(imageBuffer.data(), 0, face);
+            glTextureSubImage3D(cubemap, 0, 0, 0, face, width, height, 1, GL_RGBA, GL_UNSIGNED_BYTE, imageBuffer.data());
+        }
+        glGenerateTextureMipmap(cubemap);
     }
 
     void loadScene(const std::string& filename) {
     }
 
     void render(Framebuffer& framebuffer) {
-        xr::for_each_side_index([&](uint32_t eyeIndex) {
-            framebuffer.setViewportSide(eyeIndex);
-        });
+        if (0 == cubemap) {
+            return;
+        }
+
+        // The skybox is drawn at the far plane, behind anything else, so needs neither depth testing nor writes
+        glDisable(GL_DEPTH_TEST);
+        glDepthMask(GL_FALSE);
+        glBindTextureUnit(0, cubemap);
+        if (framebuffer.isMultiview()) {
+            // Both eyes with one draw
+            framebuffer.setViewportSide(0);
+            if (0 == multiviewSkybox.program) {
+                multiviewSkybox.create();
+            }
+            multiviewSkybox.bind();
+            glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        } else {
+            skybox.bind();
+            xr::for_each_side_index([&](uint32_t eyeIndex) {
+                framebuffer.setViewportSide(eyeIndex);
+                glProgramUniform1i(skybox.program, EYE_INDEX_LOCATION, (GLint)eyeIndex);
+                glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+            });
+        }
+        glBindVertexArray(0);
+        glUseProgram(0);
+        glDepthMask(GL_TRUE);
+        glEnable(GL_DEPTH_TEST);
     }
 
+    Pipeline skybox;
+    Pipeline multiviewSkybox;
+    uint32_t cubemap{ 0 };
+
     HandStates handStates;
     EyeStates eyeStates;
 };
@@ -63,16 +138,3 @@ void Scene::updateHands(const xr_examples::HandStates& handStates) {
 void Scene::updateEyes(const xr_examples::EyeStates& eyeStates) {
     d->eyeStates = eyeStates;
 }
-
-#if 0 
-struct GLState {
-        uint32_t vao{ 0 };
-        uint32_t skyboxPipeline{ 0 };
-        uint32_t skyboxCubemap{ 0 };
-        uint32_t blitPipeline{ 0 };
-        uint32_t eyeViewsBuffer{ 0 };
-        gl::EyeViews eyeViewsData;
-        gl::MultiviewFramebuffer sceneFramebuffer;
-    } glState;
-
-#endif
\ No newline at end of file
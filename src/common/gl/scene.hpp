@@ -10,6 +10,8 @@ class Scene : public xr_examples::Scene {
 
 public:
     virtual ~Scene();
+    bool supportsMultiview() const override { return true; }
+    bool readsEyeViews() const override { return true; }
     void render(xr_examples::Framebuffer& stereoFramebuffer) override;
     void create() override;
     void setCubemap(const std::string& cubemapPrefix) override;
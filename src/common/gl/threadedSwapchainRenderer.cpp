@@ -1,66 +1,113 @@
 #include "threadedSwapchainRenderer.hpp"
 
-#include <gl/debug.hpp>
+#include <algorithm>
+
+#include <logging.hpp>
 
 #include <glad/glad.h>
 
 using namespace xr_examples;
 using namespace xr_examples::gl;
 
-void ThreadedSwapchainRenderer::create(const xr::Extent2Di& size, const xr::Session& session, Window& window) {
+void ThreadedSwapchainRenderer::create(const xr::Extent2Di& size, const xr::Session& session, RenderWorkerPool& pool) {
+    framesInFlight = std::clamp<uint32_t>(framesInFlight, 1, MAX_FRAMES_IN_FLIGHT);
+
     auto swapchain = session.createSwapchain(xr::SwapchainCreateInfo{
         {}, xr::SwapchainUsageFlagBits::TransferDst, GL_RGBA8, 1, (uint32_t)size.width, (uint32_t)size.height, 1, 1, 1 });
     framebuffer.setSwapchain(swapchain);
 
-    auto glContext = window.createOffscreenContext();
-    glContext->makeCurrent();
-    gl::enableDebugLogging();
-    // Framebuffers are not shared between contexts, so we have to create ours AFTER creating and making the offscreen context current
-    framebuffer.create(size);
-    // Always make sure the first entry in the swapchain is valid for submission in a layer BEFORE we return on the main thread
-    {
-        framebuffer.bind();
-        framebuffer.clear();
-        framebuffer.bindDefault();
-        framebuffer.advance();
-    }
-    // Let derived class do any one-time GL context setup required
-    initContext();
-    // Release offscreen context on the main thread
-    glContext->doneCurrent();
-
-    // Launch the rendering thread.  The offscreen context will remain current on that thread for the duration
-    thread = std::make_unique<std::thread>([=] {
-        glContext->makeCurrent();
-        run();
-        glContext->doneCurrent();
-        glContext->destroy();
+    quit = false;
+    this->pool = &pool;
+    worker = pool.acquireWorker();
+    pool.run(worker, [&] {
+        // Framebuffers are not shared between contexts, so we have to create ours on the worker's context
+        framebuffer.create(size);
+        // Always make sure the first entry in the swapchain is valid for submission in a layer BEFORE we return on the
+        // main thread
+        {
+            framebuffer.bind();
+            framebuffer.clear();
+            framebuffer.bindDefault();
+            framebuffer.advance();
+        }
+        // Let derived class do any one-time GL context setup required
+        initContext();
     });
+}
 
-    window.makeCurrent();
+bool ThreadedSwapchainRenderer::requestNewFrame(const xr::Time& displayTime,
+                                                const EyeStates& eyeStates,
+                                                const HandStates& handStates) {
+    // Only this thread ever increments `inFlight`, so it can't grow past the limit between the check and the push
+    if (!pool || inFlight.load(std::memory_order_acquire) >= framesInFlight ||
+        !requests.push({ displayTime, eyeStates, handStates, Clock::now() })) {
+        ++droppedRequests;
+        return false;
+    }
+    ++inFlight;
+    // Pairs with the fence in `renderQueued()`: either the pending job sees this request, or this sees that there's
+    // no job pending any more and submits one
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!scheduled.exchange(true)) {
+        pool->submit(worker, [this] { renderQueued(); });
+    }
+    return true;
 }
 
-void ThreadedSwapchainRenderer::requestNewFrame() {
-    Lock lock{ mutex };
-    frameRequested = true;
-    conditional.notify_one();
+void ThreadedSwapchainRenderer::stop() {
+    if (!pool) {
+        return;
+    }
+    quit = true;
+    // Runs after any render job still pending, which drops the requests it hasn't started on
+    pool->run(worker, [this] {
+        profiler.logSummary("GPU (render worker)");
+        profiler.destroy();
+        framebuffer.destroy();
+    });
+    pool->releaseWorker(worker);
+    pool = nullptr;
+    if (latencyStats.samples != 0) {
+        LOG_INFO("Render worker latency over {} frames: min {:.3f} ms, avg {:.3f} ms, max {:.3f} ms, {} dropped",
+                 latencyStats.samples, latencyStats.min, latencyStats.avg, latencyStats.max, droppedRequests.load());
+    }
 }
 
-void ThreadedSwapchainRenderer::run() {
-    using namespace std::chrono_literals;
-    while (!quit) {
-        Lock lock(mutex);
-        if (!conditional.wait_for(lock, 100ms, [this] { return frameRequested; })) {
-            continue;
-        }
-        frameRequested = false;
+void ThreadedSwapchainRenderer::renderQueued() {
+    scheduled = false;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    FrameRequest request;
+    // Requests still queued when stopping are dropped, the session may no longer hand out swapchain images
+    while (!quit && requests.pop(request)) {
         framebuffer.bind();
-        render();
+        {
+            auto gpuZone = profiler.zone(gl::zone::UI_LAYER);
+            render(request);
+        }
         framebuffer.bindDefault();
         framebuffer.advance();
+        --inFlight;
+        recordLatency(request);
+        if (releaseCallback) {
+            releaseCallback(request);
+        }
     }
 }
 
+void ThreadedSwapchainRenderer::recordLatency(const FrameRequest& request) {
+    auto latency = std::chrono::duration<float, std::milli>(Clock::now() - request.requestTime).count();
+    auto& stats = latencyStats;
+    stats.last = latency;
+    if (stats.samples == 0) {
+        stats.min = stats.max = stats.avg = latency;
+    } else {
+        stats.min = std::min(stats.min, latency);
+        stats.max = std::max(stats.max, latency);
+        stats.avg += (latency - stats.avg) / (float)(stats.samples + 1);
+    }
+    ++stats.samples;
+}
+
 const xr::Swapchain& ThreadedSwapchainRenderer::getSwapchain() const {
     return framebuffer.swapchain;
-}
\ No newline at end of file
+}
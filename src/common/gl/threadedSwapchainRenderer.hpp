@@ -1,32 +1,89 @@
 #pragma once
 
 #include <interfaces.hpp>
+#include <spscQueue.hpp>
 #include <gl/framebuffer.hpp>
-#include <mutex>
+#include <gl/profiler.hpp>
+#include <gl/renderWorkerPool.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
 
 namespace xr_examples { namespace gl {
 
+// Renders a swapchain on a worker of a `RenderWorkerPool`, shared with other offscreen layers.  The frame loop hands
+// over frame requests through a lock-free queue, and never waits on the worker: a request that would exceed
+// `framesInFlight` requested but not yet released frames is dropped.  A render job is only submitted to the worker
+// when there isn't one already pending for this layer, and it renders every request queued by the time it runs.
+//
+// Derived classes must call `stop()` in their destructors, since the worker calls back into them.
 class ThreadedSwapchainRenderer {
 public:
-    void requestNewFrame();
+    using Clock = std::chrono::steady_clock;
+    static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 4;
+
+    // Everything the frame needs from the frame loop, snapshotted when it's requested, so that the worker never reads
+    // state the frame loop is updating
+    struct FrameRequest {
+        xr::Time displayTime;
+        EyeStates eyeStates;
+        HandStates handStates;
+        Clock::time_point requestTime;
+    };
+
+    // Request to release of a frame's swapchain image, in milliseconds
+    struct LatencyStats {
+        float last{ 0.0f };
+        float min{ 0.0f };
+        float max{ 0.0f };
+        float avg{ 0.0f };
+        uint32_t samples{ 0 };
+    };
+
+    // Called on the worker once a frame's swapchain image has been released, and may be submitted in a layer
+    using ReleaseCallback = std::function<void(const FrameRequest&)>;
 
-    virtual void render() = 0;
+    virtual ~ThreadedSwapchainRenderer() { stop(); }
+
+    // Returns false if the request was dropped because too many frames are already in flight
+    bool requestNewFrame(const xr::Time& displayTime, const EyeStates& eyeStates, const HandStates& handStates);
+
+    virtual void render(const FrameRequest& request) = 0;
     virtual void initContext() = 0;
 
-    virtual void create(const xr::Extent2Di& size, const xr::Session& session, Window& window);
+    // Set before `create()`, clamped to [1, MAX_FRAMES_IN_FLIGHT]
+    uint32_t framesInFlight{ 2 };
+
+    // Pins the layer to a worker of `pool`, which must outlive it, and calls `initContext()` there
+    virtual void create(const xr::Extent2Di& size, const xr::Session& session, RenderWorkerPool& pool);
+    // Finishes the frame being rendered, drops any still queued, and releases the layer's GL resources on the worker
+    void stop();
+    void setReleaseCallback(const ReleaseCallback& callback) { releaseCallback = callback; }
     const xr::Swapchain& getSwapchain() const;
+    // GPU times of the layer, recorded on the worker's context under `zone::UI_LAYER`
+    const Profiler& getProfiler() const { return profiler; }
+    // Only safe to read once the thread has been stopped
+    const LatencyStats& getLatencyStats() const { return latencyStats; }
+    uint32_t getDroppedRequests() const { return droppedRequests.load(); }
 
 private:
-    using Mutex = std::mutex;
-    using Lock = std::unique_lock<Mutex>;
+    void renderQueued();
+    void recordLatency(const FrameRequest& request);
 
     SwapchainFramebuffer framebuffer;
-    std::condition_variable conditional;
-    std::mutex mutex;
-    std::unique_ptr<std::thread> thread;
-    bool frameRequested{ false };
-    bool quit{ false };
-    void run();
+    Profiler profiler;
+    SpscQueue<FrameRequest, MAX_FRAMES_IN_FLIGHT> requests;
+    std::atomic<uint32_t> inFlight{ 0 };
+    std::atomic<uint32_t> droppedRequests{ 0 };
+    // Whether a job to render the queued requests has been submitted to the worker and hasn't started on them yet
+    std::atomic<bool> scheduled{ false };
+    std::atomic<bool> quit{ false };
+    RenderWorkerPool* pool{ nullptr };
+    uint32_t worker{ 0 };
+    ReleaseCallback releaseCallback;
+    LatencyStats latencyStats;
 };
 
-}}  // namespace xr_examples::gl
\ No newline at end of file
+}}  // namespace xr_examples::gl
@@ -81,6 +81,7 @@ struct Window::Private {
     }
 
     GLFWwindow* window{ nullptr };
+    uint32_t loopInterval{ 0 };
 };
 
 void Window::init() {
@@ -136,9 +137,17 @@ xr_examples::Context::Pointer Window::createOffscreenContext() const {
     return std::make_shared<OffscreenContext>(d->window);
 }
 
+void Window::setLoopInterval(uint32_t milliseconds) {
+    d->loopInterval = milliseconds;
+}
+
 void Window::runWindowLoop(const std::function<void()>& handler) {
     while (0 == glfwWindowShouldClose(d->window)) {
-        glfwPollEvents();
+        if (d->loopInterval != 0) {
+            glfwWaitEventsTimeout((double)d->loopInterval / 1000.0);
+        } else {
+            glfwPollEvents();
+        }
         handler();
     }
 }
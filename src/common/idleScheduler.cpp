@@ -0,0 +1,32 @@
+//
+//  Created by Bradley Austin Davis
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#include "idleScheduler.hpp"
+
+#include <algorithm>
+
+using namespace xr_examples;
+
+uint32_t IdleScheduler::update(xr::SessionState state, bool running) {
+    if (running || state != lastState) {
+        interval = 0;
+    } else if (interval == 0) {
+        interval = minInterval;
+    } else {
+        interval = std::min(interval * 2, maxInterval);
+    }
+    lastState = state;
+    return interval;
+}
+
+bool IdleScheduler::shouldRefreshMirror() {
+    auto now = Clock::now();
+    if (isIdle() && (now - lastMirrorRefresh) < std::chrono::milliseconds(mirrorInterval)) {
+        return false;
+    }
+    lastMirrorRefresh = now;
+    return true;
+}
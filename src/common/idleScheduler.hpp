@@ -0,0 +1,41 @@
+//
+//  Created by Bradley Austin Davis
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <openxr/openxr.hpp>
+
+namespace xr_examples {
+
+// Paces the window loop while the XR session isn't running frames (Idle, Ready before the session has begun,
+// Stopping, ...).  Once the frame loop is running, xrWaitFrame throttles it, but outside of that nothing does and
+// the loop would otherwise spin on xrPollEvent.  Each consecutive idle iteration doubles the wait before the next
+// one, up to `maxInterval`, and any session state change drops it back to zero so the loop reacts on the very next
+// iteration.  While idle the desktop mirror is only refreshed every `mirrorInterval`.
+class IdleScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    uint32_t minInterval{ 1 };
+    uint32_t maxInterval{ 32 };
+    uint32_t mirrorInterval{ 250 };
+
+    // Call once per loop iteration after polling the XR events.  Returns how long, in milliseconds, the window
+    // loop should wait before the next iteration, zero meaning not at all
+    uint32_t update(xr::SessionState state, bool running);
+    bool isIdle() const { return interval != 0; }
+    // Always true while the frame loop is running, otherwise true at most once per `mirrorInterval`
+    bool shouldRefreshMirror();
+
+private:
+    xr::SessionState lastState{ xr::SessionState::Unknown };
+    uint32_t interval{ 0 };
+    Clock::time_point lastMirrorRefresh;
+};
+
+}  // namespace xr_examples
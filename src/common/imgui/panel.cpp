@@ -175,9 +175,9 @@ void Renderer::initContext() {
     d = std::make_shared<Private>();
 }
 
-void Renderer::render() {
+void Renderer::render(const FrameRequest& request) {
     if (d && handler) {
-        handler();
+        handler(request);
         d->render();
     }
 }
@@ -12,10 +12,13 @@ class Renderer : public xr_examples::gl::ThreadedSwapchainRenderer {
     struct Private;
 
 public:
-    using Handler = std::function<void()>;
+    using FrameRequest = Parent::FrameRequest;
+    using Handler = std::function<void(const FrameRequest&)>;
     static void init();
 
-    void render() override;
+    ~Renderer() override { stop(); }
+
+    void render(const FrameRequest& request) override;
     void initContext() override;
     void setHandler(const Handler& handler);
 
@@ -5,6 +5,9 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 #include "interfaces.hpp"
+
+#include <array>
+
 #include <glad/glad.h>
 
 using namespace xr_examples;
@@ -24,3 +27,72 @@ void Framebuffer::blit(uint32_t source,
                            0, 0, destSize.width, destSize.height,      //
                            mask, filter);
 }
+
+void Framebuffer::blit(uint32_t source,
+                       const xr::Rect2Di& sourceRect,
+                       uint32_t dest,
+                       const xr::Rect2Di& destRect,
+                       uint32_t mask,
+                       Filter filter) {
+    const auto& src = sourceRect;
+    const auto& dst = destRect;
+    glBlitNamedFramebuffer(source, dest,                                                                                   //
+                           src.offset.x, src.offset.y, src.offset.x + src.extent.width, src.offset.y + src.extent.height,  //
+                           dst.offset.x, dst.offset.y, dst.offset.x + dst.extent.width, dst.offset.y + dst.extent.height,  //
+                           mask, filter);
+}
+
+void Framebuffer::applyLoadOps(uint32_t fbo, const RenderPass& renderPass) {
+    // At most color, depth and stencil, kept off the heap as this runs at both ends of every pass
+    std::array<GLenum, 3> invalidated;
+    GLsizei invalidatedCount = 0;
+
+    switch (renderPass.color.load) {
+        case LoadOp::Clear:
+            glClearNamedFramebufferfv(fbo, GL_COLOR, 0, &renderPass.clearColor.r);
+            break;
+        case LoadOp::DontCare:
+            invalidated[invalidatedCount++] = GL_COLOR_ATTACHMENT0;
+            break;
+        default:
+            break;
+    }
+
+    // A combined clear is cheaper for packed depth stencil formats
+    bool clearDepth = renderPass.depth.load == LoadOp::Clear;
+    bool clearStencil = renderPass.stencil.load == LoadOp::Clear;
+    if (clearDepth && clearStencil) {
+        glClearNamedFramebufferfi(fbo, GL_DEPTH_STENCIL, 0, renderPass.clearDepth, renderPass.clearStencil);
+    } else if (clearDepth) {
+        glClearNamedFramebufferfv(fbo, GL_DEPTH, 0, &renderPass.clearDepth);
+    } else if (clearStencil) {
+        glClearNamedFramebufferiv(fbo, GL_STENCIL, 0, &renderPass.clearStencil);
+    }
+    if (renderPass.depth.load == LoadOp::DontCare) {
+        invalidated[invalidatedCount++] = GL_DEPTH_ATTACHMENT;
+    }
+    if (renderPass.stencil.load == LoadOp::DontCare) {
+        invalidated[invalidatedCount++] = GL_STENCIL_ATTACHMENT;
+    }
+
+    if (invalidatedCount != 0) {
+        glInvalidateNamedFramebufferData(fbo, invalidatedCount, invalidated.data());
+    }
+}
+
+void Framebuffer::applyStoreOps(uint32_t fbo, const RenderPass& renderPass) {
+    std::array<GLenum, 3> invalidated;
+    GLsizei invalidatedCount = 0;
+    if (renderPass.color.store == StoreOp::Discard) {
+        invalidated[invalidatedCount++] = GL_COLOR_ATTACHMENT0;
+    }
+    if (renderPass.depth.store == StoreOp::Discard) {
+        invalidated[invalidatedCount++] = GL_DEPTH_ATTACHMENT;
+    }
+    if (renderPass.stencil.store == StoreOp::Discard) {
+        invalidated[invalidatedCount++] = GL_STENCIL_ATTACHMENT;
+    }
+    if (invalidatedCount != 0) {
+        glInvalidateNamedFramebufferData(fbo, invalidatedCount, invalidated.data());
+    }
+}
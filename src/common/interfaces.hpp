@@ -36,6 +36,10 @@ struct Context {
     virtual void makeCurrent() const = 0;
     virtual void doneCurrent() const = 0;
     virtual void destroy() {}
+    // Offscreen contexts that are made current on the surface of the window they were created from can present to
+    // it, from whichever thread they are current on, see `Window::createOffscreenContext()`
+    virtual bool canPresent() const { return false; }
+    virtual void present() const {}
 };
 
 struct Window : public Context {
@@ -43,6 +47,9 @@ struct Window : public Context {
     virtual void setSwapInterval(uint32_t swapInterval) const = 0;
     virtual void setTitle(const ::std::string& title) const = 0;
     virtual void runWindowLoop(const ::std::function<void()>& handler) = 0;
+    // How long the window loop waits, while still servicing window events, between calls to the loop handler.
+    // Zero, the default, calls the handler again as soon as it returns
+    virtual void setLoopInterval(uint32_t milliseconds) = 0;
     virtual void swapBuffers() const = 0;
     virtual void requestClose() = 0;
     virtual Context::Pointer createOffscreenContext() const { return {}; }
@@ -69,6 +76,38 @@ struct Framebuffer {
         Linear = 0x2601,
     };
 
+    // What happens to an attachment's contents at the start of a render pass
+    enum class LoadOp
+    {
+        Clear,
+        Load,
+        // The previous contents aren't needed, so the driver can skip loading them
+        DontCare,
+    };
+
+    // What happens to an attachment's contents at the end of a render pass
+    enum class StoreOp
+    {
+        Store,
+        // The contents aren't needed after the pass, so the driver can skip writing them back to memory
+        Discard,
+    };
+
+    struct AttachmentOps {
+        LoadOp load{ LoadOp::Clear };
+        StoreOp store{ StoreOp::Store };
+    };
+
+    // Declares how a pass uses each attachment, see `beginRenderPass` and `endRenderPass`
+    struct RenderPass {
+        AttachmentOps color;
+        AttachmentOps depth;
+        AttachmentOps stencil;
+        xr::Color4f clearColor{ 0, 0, 0, 1 };
+        float clearDepth{ 1.0f };
+        int clearStencil{ 0 };
+    };
+
     void blitTo(uint32_t dest, const xr::Extent2Di& destSize, uint32_t mask = Color, Filter filter = Nearest);
 
     static void blit(uint32_t source,
@@ -78,31 +117,84 @@ struct Framebuffer {
                      uint32_t mask = Color,
                      Filter filter = Nearest);
 
+    static void blit(uint32_t source,
+                     const xr::Rect2Di& sourceRect,
+                     uint32_t dest,
+                     const xr::Rect2Di& destRect,
+                     uint32_t mask = Color,
+                     Filter filter = Nearest);
+
     virtual void create(const xr::Extent2Di& size) = 0;
     virtual void destroy() = 0;
     virtual void bind(Target target = Draw) = 0;
+    // Binds the framebuffer for drawing and applies the load ops of the pass, clearing only the attachments that
+    // are to be cleared and invalidating those whose contents don't matter
+    virtual void beginRenderPass(const RenderPass& renderPass) = 0;
+    // Invalidates the attachments the pass doesn't store, then binds the default framebuffer
+    virtual void endRenderPass(const RenderPass& renderPass) = 0;
     virtual void clear(const xr::Color4f& color = { 0, 0, 0, 1 }, float depth = 1.0f, int stencil = 0) = 0;
     virtual void bindDefault(Target target = Draw) = 0;
     virtual void setViewport(const xr::Rect2Di& viewport) = 0;
     virtual uint32_t id() = 0;
-
-    virtual void setViewportSide(uint32_t side) final {
-        xr::Rect2Di result{ { 0, 0 }, eyeSize };
-        if (side == 1) {
+    // Render into `texture` instead of the framebuffer's own color buffer, or back into the latter if `texture` is
+    // zero.  The texture must match the framebuffer's size and be shared with the context it renders on
+    virtual void setColorAttachment(uint32_t texture) = 0;
+    // Likewise for the depth buffer, e.g. to render straight into a depth swapchain image.  If the texture's format
+    // has no stencil component the framebuffer has no stencil buffer until the texture is replaced.
+    virtual void setDepthAttachment(uint32_t texture, bool hasStencil = true) = 0;
+    // The texture the framebuffer currently renders color to, for sampling the result on the window's context
+    virtual uint32_t getColorTexture() const = 0;
+    // Set before `create()` if the color buffer is always set with `setColorAttachment`, e.g. to the acquired
+    // swapchain image, so that the framebuffer doesn't allocate a color buffer of its own up front.  It's then only
+    // allocated if `setColorAttachment(0)` asks for it
+    virtual void setExternalColor(bool externalColor) final { this->externalColor = externalColor; }
+
+    // The region of the framebuffer each eye renders to.  With a viewport scale below 1 only the bottom left
+    // corner of each eye's half of the framebuffer is used, see `setViewportScale`.  A multiview framebuffer has
+    // one layer per eye, so both eyes use the same region of their own layer.
+    virtual xr::Rect2Di getViewportSide(uint32_t side) const final {
+        xr::Rect2Di result{ { 0, 0 }, { (int32_t)((float)eyeSize.width * viewportScale),
+                                        (int32_t)((float)eyeSize.height * viewportScale) } };
+        if (side == 1 && !multiview) {
             result.offset.x += eyeSize.width;
         }
-        setViewport(result);
+        return result;
     }
 
+    virtual void setViewportSide(uint32_t side) final { setViewport(getViewportSide(side)); }
+
+    // Scales the per-eye viewports without reallocating the framebuffer, for dynamic resolution
+    virtual void setViewportScale(float scale) final { viewportScale = scale; }
+    virtual float getViewportScale() const final { return viewportScale; }
+
     virtual const xr::Extent2Di& getSize() const final { return size; }
     virtual const xr::Extent2Di& getEyeSize() const final { return eyeSize; }
+    // True if the framebuffer is a texture array with one layer per eye, which renders both eyes with a single set of
+    // draws via GL_OVR_multiview
+    virtual bool isMultiview() const final { return multiview; }
 
 protected:
+    // GL implementations of the render pass ops, for framebuffers that can name their FBO on the current context
+    static void applyLoadOps(uint32_t fbo, const RenderPass& renderPass);
+    static void applyStoreOps(uint32_t fbo, const RenderPass& renderPass);
+
     xr::Extent2Di size;
     xr::Extent2Di eyeSize;
+    float viewportScale{ 1.0f };
+    bool multiview{ false };
+    bool externalColor{ false };
 };
 
 class Scene {
+public:
+    // Scenes that can render into a multiview framebuffer, see `Framebuffer::isMultiview`
+    virtual bool supportsMultiview() const { return false; }
+    // Scenes that render into whichever framebuffer they are given, and can be rendered more than once a frame with
+    // different eye states, as foveated rendering does for its inset.  See `Foveation`
+    virtual bool supportsFoveation() const { return true; }
+    // Scenes whose shaders read the views from the `EyeViews` uniform block, see `gl::EyeViewsUniformBuffer`.  The
+    // block is only written for them, and only their views can be late latched after their draws are issued
+    virtual bool readsEyeViews() const { return false; }
     virtual void render(Framebuffer& stereoFramebuffer) = 0;
     virtual void create() = 0;
     virtual void setCubemap(const std::string& cubemapPrefix) = 0;
@@ -110,6 +202,15 @@ class Scene {
     virtual void destroy() {}
     virtual void updateHands(const HandStates& handStates) = 0;
     virtual void updateEyes(const EyeStates& eyeStates) = 0;
+    // The near and far planes of the eye projections, which must match those submitted with the depth of the layer
+    virtual void setClipPlanes(float nearZ, float farZ) {
+        this->nearZ = nearZ;
+        this->farZ = farZ;
+    }
+
+protected:
+    float nearZ{ 0.01f };
+    float farZ{ 1000.0f };
 };
 
 }  // namespace xr_examples
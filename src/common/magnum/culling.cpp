@@ -0,0 +1,164 @@
+#include "culling.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <Magnum/Math/Quaternion.h>
+
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define CULLING_SSE 1
+#include <xmmintrin.h>
+#endif
+
+using namespace Magnum;
+using namespace xr_examples::magnum;
+
+Frustum Frustum::fromMatrix(const Matrix4& viewProjection) {
+    auto x = viewProjection.row(0);
+    auto y = viewProjection.row(1);
+    auto z = viewProjection.row(2);
+    auto w = viewProjection.row(3);
+    return { { Vector4{ w + x }, Vector4{ w - x }, Vector4{ w + y }, Vector4{ w - y }, Vector4{ w + z },
+               Vector4{ w - z } } };
+}
+
+Frustum Frustum::enclosingStereo(const std::array<Matrix4, 2>& eyeTransforms,
+                                 const std::array<xr::Fovf, 2>& fovs,
+                                 float nearZ,
+                                 float farZ) {
+    std::array<Quaternion, 2> orientations;
+    std::array<Vector3, 2> positions;
+    for (size_t i = 0; i < 2; ++i) {
+        orientations[i] = Quaternion::fromMatrix(eyeTransforms[i].rotationScaling());
+        positions[i] = eyeTransforms[i].translation();
+    }
+    if (Math::dot(orientations[0], orientations[1]) < 0.0f) {
+        orientations[1] = -orientations[1];
+    }
+    auto orientation = Math::slerp(orientations[0], orientations[1], 0.5f);
+    // Half the angle between the eyes, which is how far each is turned away from `orientation`
+    auto cant = std::acos(std::min(Math::dot(orientations[0], orientations[1]), 1.0f));
+
+    // Kept within a right angle of the view direction, so that the tangents stay finite and of the right sign
+    static const float MAX_ANGLE = 1.5f;
+    auto clampAngle = [](float angle) { return std::clamp(angle, -MAX_ANGLE, MAX_ANGLE); };
+    xr::Fovf fov;
+    fov.angleLeft = clampAngle(std::min(fovs[0].angleLeft, fovs[1].angleLeft) - cant);
+    fov.angleRight = clampAngle(std::max(fovs[0].angleRight, fovs[1].angleRight) + cant);
+    fov.angleDown = clampAngle(std::min(fovs[0].angleDown, fovs[1].angleDown) - cant);
+    fov.angleUp = clampAngle(std::max(fovs[0].angleUp, fovs[1].angleUp) + cant);
+    // An eye's frustum is inside the combined one if the eye is, since the combined planes are at least as wide.  An
+    // eye at `local` in the combined frame, looking down -Z, is inside if its offset from the apex, pulled back to
+    // +Z by `retreat`, is within each side's tangent of its distance ahead of the apex
+    auto tanLeft = std::min(std::tan(fov.angleLeft), -0.01f);
+    auto tanRight = std::max(std::tan(fov.angleRight), 0.01f);
+    auto tanDown = std::min(std::tan(fov.angleDown), -0.01f);
+    auto tanUp = std::max(std::tan(fov.angleUp), 0.01f);
+    auto center = (positions[0] + positions[1]) * 0.5f;
+    auto inverseOrientation = orientation.inverted();
+    float retreat = 0.0f;
+    for (const auto& position : positions) {
+        auto local = inverseOrientation.transformVector(position - center);
+        retreat = std::max({ retreat, local.z() + local.x() / tanLeft, local.z() + local.x() / tanRight,
+                             local.z() + local.y() / tanDown, local.z() + local.y() / tanUp });
+    }
+
+    auto apex = center + orientation.transformVector({ 0.0f, 0.0f, retreat });
+    auto cameraMatrix = Matrix4::from(orientation.toMatrix(), apex).invertedRigid();
+    return fromMatrix(fromXrGL(fov, nearZ, farZ + retreat) * cameraMatrix);
+}
+
+Range3D xr_examples::magnum::transformBox(const Range3D& box, const Matrix4& transformation) {
+    auto center = transformation.transformPoint(box.center());
+    auto halfSize = box.size() * 0.5f;
+    Vector3 extent;
+    for (size_t row = 0; row < 3; ++row) {
+        for (size_t column = 0; column < 3; ++column) {
+            extent[row] += std::abs(transformation[column][row]) * halfSize[column];
+        }
+    }
+    return { center - extent, center + extent };
+}
+
+void BoxCuller::resize(size_t newCount) {
+    count = newCount;
+    for (auto* coordinates : { &minX, &minY, &minZ, &maxX, &maxY, &maxZ }) {
+        coordinates->resize(count + BATCH);
+    }
+}
+
+void BoxCuller::set(size_t index, const Range3D& box) {
+    minX[index] = box.min().x();
+    minY[index] = box.min().y();
+    minZ[index] = box.min().z();
+    maxX[index] = box.max().x();
+    maxY[index] = box.max().y();
+    maxZ[index] = box.max().z();
+}
+
+void BoxCuller::setUnbounded(size_t index) {
+    // Finite, so that a zero plane coefficient can't make the distance NaN
+    static const float MAX = std::numeric_limits<float>::max();
+    set(index, Range3D{ Vector3{ -MAX }, Vector3{ MAX } });
+}
+
+Range3D BoxCuller::get(size_t index) const {
+    return { { minX[index], minY[index], minZ[index] }, { maxX[index], maxY[index], maxZ[index] } };
+}
+
+Vector3 BoxCuller::getCenter(size_t index) const {
+    return Vector3{ minX[index] + maxX[index], minY[index] + maxY[index], minZ[index] + maxZ[index] } * 0.5f;
+}
+
+void BoxCuller::cull(const Frustum& frustum, size_t begin, size_t end, uint8_t bits, uint8_t* masks) const {
+    for (size_t index = begin; index < end; index += BATCH) {
+        auto lanes = std::min(BATCH, end - index);
+        // Nothing to clear, as for a batch culled along with the subtree it's in
+        uint8_t any = 0;
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            any |= masks[index + lane];
+        }
+        if (0 == (any & bits)) {
+            continue;
+        }
+        auto outside = testBatch(frustum, index);
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            if (0 != (outside & (1u << lane))) {
+                masks[index + lane] &= (uint8_t)~bits;
+            }
+        }
+    }
+}
+
+// For each plane, the corner of each box furthest along the plane's normal is the one to test: if even that is behind
+// the plane, the whole box is.  Which corner that is depends only on the signs of the normal, so it's the same for
+// every box of the batch.
+uint32_t BoxCuller::testBatch(const Frustum& frustum, size_t index) const {
+#ifdef CULLING_SSE
+    __m128 outside = _mm_setzero_ps();
+    for (const auto& plane : frustum.planes) {
+        __m128 x = _mm_loadu_ps((plane.x() >= 0.0f ? maxX : minX).data() + index);
+        __m128 y = _mm_loadu_ps((plane.y() >= 0.0f ? maxY : minY).data() + index);
+        __m128 z = _mm_loadu_ps((plane.z() >= 0.0f ? maxZ : minZ).data() + index);
+        __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(plane.x())), _mm_mul_ps(y, _mm_set1_ps(plane.y()))),
+                                     _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(plane.z())), _mm_set1_ps(plane.w())));
+        outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, _mm_setzero_ps()));
+    }
+    return (uint32_t)_mm_movemask_ps(outside);
+#else
+    uint32_t outside = 0;
+    for (const auto& plane : frustum.planes) {
+        const auto* x = (plane.x() >= 0.0f ? maxX : minX).data() + index;
+        const auto* y = (plane.y() >= 0.0f ? maxY : minY).data() + index;
+        const auto* z = (plane.z() >= 0.0f ? maxZ : minZ).data() + index;
+        for (uint32_t lane = 0; lane < BATCH; ++lane) {
+            auto distance = x[lane] * plane.x() + y[lane] * plane.y() + z[lane] * plane.z() + plane.w();
+            if (distance < 0.0f) {
+                outside |= 1u << lane;
+            }
+        }
+    }
+    return outside;
+#endif
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <magnum/math.hpp>
+
+namespace xr_examples { namespace magnum {
+
+// The six planes of a view frustum in world space, as (normal, distance) with the normals pointing inwards.  The
+// planes aren't normalized, only the sign of the distance to them matters for culling
+struct Frustum {
+    std::array<Magnum::Vector4, 6> planes;
+
+    // Extracts the planes of the frustum of a projection times camera matrix, after Gribb and Hartmann
+    static Frustum fromMatrix(const Magnum::Matrix4& viewProjection);
+    // A single frustum enclosing both eyes' frustums, given each eye's rigid world transform and field of view.  Its
+    // field of view is the union of the eyes', widened by how far each eye is turned away from the average of their
+    // orientations, and its apex is pulled back behind the eyes just far enough that both eyes are inside it
+    static Frustum enclosingStereo(const std::array<Magnum::Matrix4, 2>& eyeTransforms,
+                                   const std::array<xr::Fovf, 2>& fovs,
+                                   float nearZ,
+                                   float farZ);
+};
+
+// The axis aligned box enclosing `box` once transformed by `transformation`
+Magnum::Range3D transformBox(const Magnum::Range3D& box, const Magnum::Matrix4& transformation);
+
+// World space axis aligned boxes, tested against a frustum a batch of four at a time, one box per SIMD lane, with
+// SSE where it's available.  The boxes are kept as a structure of arrays, so that a batch is loaded with one load
+// per coordinate.  Boxes can be set and culled concurrently from different threads, as long as the index ranges
+// don't overlap.
+class BoxCuller {
+public:
+    static constexpr size_t BATCH = 4;
+
+    // Sizes the arrays for `count` boxes, keeping the existing ones.  Not thread safe
+    void resize(size_t count);
+    size_t size() const { return count; }
+    void set(size_t index, const Magnum::Range3D& box);
+    void set(size_t index, const Magnum::Range3D& box, const Magnum::Matrix4& transformation) {
+        set(index, transformBox(box, transformation));
+    }
+    // A box that's never culled
+    void setUnbounded(size_t index);
+    Magnum::Range3D get(size_t index) const;
+    Magnum::Vector3 getCenter(size_t index) const;
+    // Clears `bits` in the masks of the boxes in [begin, end) that are entirely behind one of the frustum's planes.
+    // `masks` is indexed like the boxes.  Conservative: a box near a corner of the frustum, outside it but not
+    // entirely behind any one plane, is kept.  Batches with none of `bits` left in their masks aren't tested
+    void cull(const Frustum& frustum, size_t begin, size_t end, uint8_t bits, uint8_t* masks) const;
+    // Whether the one box at `index` is entirely behind one of the frustum's planes, for boxes whose test decides
+    // whether the next ones are tested at all
+    bool isOutside(const Frustum& frustum, size_t index) const { return 0 != (testBatch(frustum, index) & 1u); }
+
+private:
+    // A bit per box of the batch starting at `index`, set for the boxes outside the frustum
+    uint32_t testBatch(const Frustum& frustum, size_t index) const;
+
+    size_t count{ 0 };
+    // Padded by a batch, so that a batch starting at any index in [0, count) can be loaded
+    std::vector<float> minX, minY, minZ;
+    std::vector<float> maxX, maxY, maxZ;
+};
+
+}}  // namespace xr_examples::magnum
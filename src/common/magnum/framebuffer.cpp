@@ -5,12 +5,15 @@
 #pragma warning(push)
 #pragma warning(disable : 4251)
 #pragma warning(disable : 4267)
+#include <Magnum/GL/Context.h>
 #include <Magnum/GL/DefaultFramebuffer.h>
 #include <Magnum/GL/Texture.h>
 #include <Magnum/GL/Renderbuffer.h>
 #include <Magnum/GL/RenderbufferFormat.h>
 #include <Magnum/GL/TextureFormat.h>
 #include <Magnum/GL/Framebuffer.h>
+#include <Magnum/GL/Renderer.h>
+#include <Magnum/Math/Color.h>
 #pragma warning(pop)
 
 #include <magnum/math.hpp>
@@ -20,23 +23,84 @@ using namespace xr_examples;
 
 struct magnum::Framebuffer::Private {
     using Formats = std::vector<GL::TextureFormat>;
+    // A framebuffer over the textures set with `setColorAttachment` and `setDepthAttachment`, with non-owning wrappers
+    // of them.  Zero for either texture means the framebuffer's own buffer
+    struct External {
+        UnsignedInt color{ 0 };
+        UnsignedInt depth{ 0 };
+        bool depthHasStencil{ true };
+        GL::Texture2D colorTexture{ NoCreate };
+        GL::Texture2D depthTexture{ NoCreate };
+        GL::Framebuffer object{ NoCreate };
+    };
+
     const Vector2i size;
+    const Formats colorFormats;
     GL::Framebuffer object;
+    // Empty until allocated, see `setExternalColor()`
     std::vector<GL::Texture2D> colors;
     GL::Renderbuffer depthStencil;
+    // One framebuffer for every combination of attachments used so far, e.g. one per swapchain image, so that
+    // cycling through the images of a swapchain just selects a framebuffer instead of re-attaching the images
+    std::vector<External> externals;
+    UnsignedInt color{ 0 };
+    UnsignedInt depth{ 0 };
+    bool depthHasStencil{ true };
 
-    Private(const Vector2i& size_, const Formats& colorFormats = Formats{ { GL::TextureFormat::RGBA8 } }) :
-        size(size_), object({ { 0, 0 }, size }) {
-        auto count = colorFormats.size();
-        colors.resize(colorFormats.size());
-        for (uint32_t i = 0; i < count; ++i) {
-            auto& color = colors[i];
-            color.setStorage(1, colorFormats[i], size);
-            object.attachTexture(GL::Framebuffer::ColorAttachment{ i }, color, 0);
+    Private(const Vector2i& size_,
+            bool externalColor,
+            const Formats& colorFormats_ = Formats{ { GL::TextureFormat::RGBA8 } }) :
+        size(size_), colorFormats(colorFormats_), object({ { 0, 0 }, size }) {
+        if (!externalColor) {
+            createColors();
         }
         depthStencil.setStorage(GL::RenderbufferFormat::Depth24Stencil8, size);
         object.attachRenderbuffer(GL::Framebuffer::BufferAttachment::DepthStencil, depthStencil);
     }
+
+    void createColors() {
+        auto count = colorFormats.size();
+        colors.resize(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            auto& texture = colors[i];
+            texture.setStorage(1, colorFormats[i], size);
+            object.attachTexture(GL::Framebuffer::ColorAttachment{ i }, texture, 0);
+        }
+    }
+
+    // The framebuffer for the current attachments, created the first time they're used
+    GL::Framebuffer& current() {
+        if (color == 0 && colors.empty()) {
+            createColors();
+        }
+        if (color == 0 && depth == 0) {
+            return object;
+        }
+        for (auto& external : externals) {
+            if (external.color == color && external.depth == depth && external.depthHasStencil == depthHasStencil) {
+                return external.object;
+            }
+        }
+
+        using BufferAttachment = GL::Framebuffer::BufferAttachment;
+        External external{ color, depth, depthHasStencil };
+        external.object = GL::Framebuffer{ { { 0, 0 }, size } };
+        if (color == 0) {
+            external.object.attachTexture(GL::Framebuffer::ColorAttachment{ 0 }, colors[0], 0);
+        } else {
+            external.colorTexture = GL::Texture2D::wrap(color);
+            external.object.attachTexture(GL::Framebuffer::ColorAttachment{ 0 }, external.colorTexture, 0);
+        }
+        if (depth == 0) {
+            external.object.attachRenderbuffer(BufferAttachment::DepthStencil, depthStencil);
+        } else {
+            external.depthTexture = GL::Texture2D::wrap(depth);
+            external.object.attachTexture(depthHasStencil ? BufferAttachment::DepthStencil : BufferAttachment::Depth,
+                                          external.depthTexture, 0);
+        }
+        externals.push_back(std::move(external));
+        return externals.back().object;
+    }
 };
 
 magnum::Framebuffer::~Framebuffer() {
@@ -47,18 +111,34 @@ void magnum::Framebuffer::create(const xr::Extent2Di& size) {
     this->size = size;
     this->eyeSize = size;
     eyeSize.width /= 2;
-    d = std::make_shared<Private>(fromXr(size));
+    d = std::make_shared<Private>(fromXr(size), externalColor);
 }
 
 void magnum::Framebuffer::clear(const xr::Color4f& color, float depth, int stencil) {
-    d->object.clear(GL::FramebufferClear::Color | GL::FramebufferClear::Depth | GL::FramebufferClear::Stencil);
+    GL::Renderer::setClearColor(Color4{ color.r, color.g, color.b, color.a });
+    GL::Renderer::setClearDepth(depth);
+    GL::Renderer::setClearStencil(stencil);
+    d->current().clear(GL::FramebufferClear::Color | GL::FramebufferClear::Depth | GL::FramebufferClear::Stencil);
+}
+
+void magnum::Framebuffer::beginRenderPass(const RenderPass& renderPass) {
+    // The mirror and the other passes of the example framework use raw GL, behind the back of Magnum's state tracker
+    GL::Context::current().resetState(GL::Context::State::ExitExternal);
+    auto& object = d->current();
+    object.bind();
+    applyLoadOps(object.id(), renderPass);
+}
+
+void magnum::Framebuffer::endRenderPass(const RenderPass& renderPass) {
+    applyStoreOps(d->current().id(), renderPass);
+    bindDefault();
 }
 
 void magnum::Framebuffer::bind(Target target) {
     if (target == Draw) {
-        d->object.bind();
+        d->current().bind();
     } else {
-        glBindFramebuffer(GL_READ_FRAMEBUFFER, d->object.id());
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, d->current().id());
     }
 }
 
@@ -71,11 +151,27 @@ void magnum::Framebuffer::bindDefault(Target target) {
 }
 
 void magnum::Framebuffer::setViewport(const xr::Rect2Di& viewport) {
-    d->object.setViewport(fromXr(viewport));
+    d->current().setViewport(fromXr(viewport));
 }
 
 uint32_t magnum::Framebuffer::id() {
-    return d->object.id();
+    return d->current().id();
+}
+
+void magnum::Framebuffer::setColorAttachment(uint32_t texture) {
+    d->color = texture;
+}
+
+uint32_t magnum::Framebuffer::getColorTexture() const {
+    if (d->color != 0) {
+        return d->color;
+    }
+    return d->colors.empty() ? 0 : d->colors[0].id();
+}
+
+void magnum::Framebuffer::setDepthAttachment(uint32_t texture, bool hasStencil) {
+    d->depth = texture;
+    d->depthHasStencil = texture == 0 || hasStencil;
 }
 
 
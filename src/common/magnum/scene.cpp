@@ -16,6 +16,7 @@
 #include <Magnum/Mesh.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/PixelStorage.h>
+#include <Magnum/GL/Context.h>
 #include <Magnum/GL/DefaultFramebuffer.h>
 #include <Magnum/GL/Mesh.h>
 #include <Magnum/GL/Buffer.h>
@@ -29,12 +30,14 @@
 #include <Magnum/ResourceManager.h>
 #include <Magnum/MeshTools/Compile.h>
 #include <Magnum/Primitives/Line.h>
+#include <Magnum/SceneGraph/AbstractFeature.h>
 #include <Magnum/SceneGraph/Camera.h>
 #include <Magnum/SceneGraph/Drawable.h>
 #include <Magnum/SceneGraph/MatrixTransformation3D.h>
 #include <Magnum/SceneGraph/Scene.h>
 #include <Magnum/Shaders/Phong.h>
 #include <Magnum/Shaders/Flat.h>
+#include <Magnum/Shaders/Generic.h>
 #include <Magnum/Trade/AbstractImporter.h>
 #include <Magnum/Trade/ImageData.h>
 #include <Magnum/Trade/MeshData3D.h>
@@ -54,9 +57,21 @@
 #include <Magnum/Primitives/Cube.h>
 #pragma warning(pop)
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
 #include <basis.hpp>
 #include <assets.hpp>
+#include <parallelFor.hpp>
 
+#include <magnum/culling.hpp>
 #include <magnum/math.hpp>
 
 namespace xr_examples { namespace magnum { namespace impl {
@@ -74,71 +89,289 @@ using SceneResourceManager = Magnum::ResourceManager<GL::Buffer,
                                                      GL::CubeMapTexture,
                                                      GL::AbstractShaderProgram>;
 
-class FlatDrawable : public SceneGraph::Drawable3D {
+// In world space
+static const Vector3 LIGHT_POSITION{ -3.0f, 10.0f, 10.0f };
+// Of the cube primitive, see `Shared::buildCubePrimitive()`
+static const Range3D CUBE_BOUNDS{ Vector3{ -1.0f }, Vector3{ 1.0f } };
+
+// A drawable with bounds to cull against the eyes' frustums, either in the space of its object or, for drawables that
+// don't follow their object, in world space.  Drawables without bounds, like the skybox, are never culled.  Every
+// drawable the scene adds to its drawable groups is one of these, and says what state it binds, to sort the draws by
+class BoundedDrawable : public SceneGraph::Drawable3D {
+public:
+    enum class Space
+    {
+        Unbounded,
+        Object,
+        World,
+    };
+
+    enum class Pass
+    {
+        Opaque,
+        // After everything opaque, at the far plane, so that only the pixels nothing else covers are shaded
+        Sky,
+    };
+
+    using SceneGraph::Drawable3D::Drawable3D;
+
+    void setBounds(const Range3D& bounds, Space space = Space::Object) {
+        _bounds = bounds;
+        _boundsSpace = space;
+    }
+    const Range3D& getBounds() const { return _bounds; }
+    Space getBoundsSpace() const { return _boundsSpace; }
+
+    virtual Pass getPass() const { return Pass::Opaque; }
+    // Whether culling what the drawable draws left nothing for the eye, beyond what its bounds say
+    virtual bool isEmpty(uint32_t) const { return false; }
+    // The GL names of the shader program and the texture the drawable binds, zero for none
+    virtual UnsignedInt getShaderId() const { return 0; }
+    virtual UnsignedInt getMaterialId() const { return 0; }
+
+private:
+    Range3D _bounds;
+    Space _boundsSpace{ Space::Unbounded };
+};
+
+// The order draws are submitted in: by pass, then by shader and by texture, so that draws binding the same state are
+// submitted together, then front to back, so that early depth testing rejects as many fragments as it can.  The GL
+// names of the shader and texture are truncated to their fields, which can at worst split a group of draws
+struct SortKey {
+    static const uint32_t DEPTH_BITS = 24;
+    static const uint32_t MATERIAL_BITS = 24;
+    static const uint32_t SHADER_BITS = 14;
+
+    // `depth` is the distance ahead of the eyes, which is quantized over [0, farZ]
+    static uint64_t make(BoundedDrawable::Pass pass, UnsignedInt shader, UnsignedInt material, float depth, float farZ) {
+        static const uint64_t MAX_DEPTH = (1ull << DEPTH_BITS) - 1;
+        auto quantizedDepth = (uint64_t)(std::clamp(depth / farZ, 0.0f, 1.0f) * (float)MAX_DEPTH);
+        uint64_t key = (uint64_t)pass;
+        key = (key << SHADER_BITS) | (shader & ((1u << SHADER_BITS) - 1));
+        key = (key << MATERIAL_BITS) | (material & ((1u << MATERIAL_BITS) - 1));
+        return (key << DEPTH_BITS) | quantizedDepth;
+    }
+
+    static uint64_t make(const BoundedDrawable& drawable, float depth, float farZ) {
+        return make(drawable.getPass(), drawable.getShaderId(), drawable.getMaterialId(), depth, farZ);
+    }
+
+    static UnsignedInt getShader(uint64_t key) {
+        return (UnsignedInt)(key >> (DEPTH_BITS + MATERIAL_BITS)) & ((1u << SHADER_BITS) - 1);
+    }
+
+    static UnsignedInt getMaterial(uint64_t key) { return (UnsignedInt)(key >> DEPTH_BITS) & ((1u << MATERIAL_BITS) - 1); }
+};
+
+// Where the frame's uniform buffer is bound, see FrameUniforms.glsl
+static const UnsignedInt FRAME_UNIFORMS_BINDING = 0;
+
+// Laid out as std140, to match FrameUniforms.glsl
+struct EyeUniforms {
+    Matrix4 viewMatrix;
+    Matrix4 projectionMatrix;
+    // Only used by stereo instancing, to squeeze each eye's clip space into its part of the stereo viewport and keep
+    // its triangles within it.  The draws that stay per eye use `projectionMatrix`
+    Matrix4 stereoProjectionMatrix;
+    std::array<Vector4, 2> clipPlanes;
+    Vector4 cameraPosition;
+    Vector4 viewLightPosition;
+};
+
+// The camera and light data every shader but Magnum's own reads, written once a frame
+struct FrameUniforms {
+    std::array<EyeUniforms, 2> eyes;
+    Vector4 lightPosition;
+};
+
+// Lit like `Shaders::Phong`, but with each eye's projection and light read from the frame's uniform buffer, so that
+// a draw only sets the transformation of its object relative to the eye, and its color
+class PhongShader : public GL::AbstractShaderProgram {
+public:
+    using Position = Shaders::Generic3D::Position;
+    using Normal = Shaders::Generic3D::Normal;
+    using TextureCoordinates = Shaders::Generic3D::TextureCoordinates;
+
+    explicit PhongShader(bool textured) {
+        GL::Shader vert(GL::Version::GL450, GL::Shader::Type::Vertex);
+        GL::Shader frag(GL::Version::GL450, GL::Shader::Type::Fragment);
+        if (textured) {
+            vert.addSource("#define TEXTURED\n");
+            frag.addSource("#define TEXTURED\n");
+        }
+        vert.addSource(assets::getAssetContents("shaders/FrameUniforms.glsl"))
+            .addSource(assets::getAssetContents("shaders/PhongShader.vert"));
+        frag.addSource(assets::getAssetContents("shaders/PhongShader.frag"));
+        if (!GL::Shader::compile({ vert, frag })) {
+            throw std::runtime_error("Failed to compile shader");
+        }
+        attachShaders({ vert, frag });
+        bindAttributeLocation(Position::Location, "position");
+        bindAttributeLocation(Normal::Location, "normal");
+        if (textured) {
+            bindAttributeLocation(TextureCoordinates::Location, "textureCoordinates");
+        }
+        if (!link()) {
+            throw std::runtime_error("Failed to compile shader");
+        }
+        _eyeIndexUniform = uniformLocation("eyeIndex");
+        _transformationMatrixUniform = uniformLocation("transformationMatrix");
+        _diffuseColorUniform = uniformLocation("diffuseColor");
+        _ambientColorUniform = uniformLocation("ambientColor");
+        _specularColorUniform = uniformLocation("specularColor");
+        _shininessUniform = uniformLocation("shininess");
+        setDiffuseColor(0xffffffff_rgbaf);
+        if (textured) {
+            setUniform(uniformLocation("diffuseTexture"), 0);
+        }
+    }
+
+    PhongShader& setEyeIndex(UnsignedInt eyeIndex) {
+        setUniform(_eyeIndexUniform, (Int)eyeIndex);
+        return *this;
+    }
+
+    PhongShader& setTransformationMatrix(const Matrix4& matrix) {
+        setUniform(_transformationMatrixUniform, matrix);
+        return *this;
+    }
+
+    PhongShader& setDiffuseColor(const Color4& color) {
+        setUniform(_diffuseColorUniform, color);
+        return *this;
+    }
+
+    PhongShader& setAmbientColor(const Color4& color) {
+        setUniform(_ambientColorUniform, color);
+        return *this;
+    }
+
+    PhongShader& setSpecularColor(const Color4& color) {
+        setUniform(_specularColorUniform, color);
+        return *this;
+    }
+
+    PhongShader& setShininess(Float shininess) {
+        setUniform(_shininessUniform, shininess);
+        return *this;
+    }
+
+    PhongShader& bindDiffuseTexture(GL::Texture2D& texture) {
+        texture.bind(0);
+        return *this;
+    }
+
+private:
+    Int _eyeIndexUniform;
+    Int _transformationMatrixUniform;
+    Int _diffuseColorUniform;
+    Int _ambientColorUniform;
+    Int _specularColorUniform;
+    Int _shininessUniform;
+};
+
+// The shaders of the drawables that aren't instanced.  With `uniformBuffer` the colored and textured drawables use
+// `PhongShader`, otherwise Magnum's Phong shader, which takes the projection, light and normal matrix with every
+// draw.  The drawables count the bytes of uniforms they set in `uniformBytes`
+struct SceneShaders {
+    Shaders::Phong colored, textured{ Shaders::Phong::Flag::DiffuseTexture };
+    PhongShader uniformColored{ false }, uniformTextured{ true };
+    Shaders::Flat3D flat;
+    bool uniformBuffer{ true };
+    size_t uniformBytes{ 0 };
+};
+
+class FlatDrawable : public BoundedDrawable {
 public:
     explicit FlatDrawable(Object3D& object,
-                             Shaders::Flat3D& shader,
-                             GL::Mesh& mesh,
-                             const Color4& color,
-                             SceneGraph::DrawableGroup3D& group) :
-        SceneGraph::Drawable3D{ object, &group },
-        _shader(shader), _mesh(mesh), _color{ color } {}
+                          SceneShaders& shaders,
+                          GL::Mesh& mesh,
+                          const Color4& color,
+                          SceneGraph::DrawableGroup3D& group) :
+        BoundedDrawable{ object, &group },
+        _shaders(shaders), _mesh(mesh), _color{ color } {}
 
     void draw(const Matrix4& transformationMatrix, SceneGraph::Camera3D& camera) override {
-        _shader.setColor(_color).setTransformationProjectionMatrix(camera.projectionMatrix() * transformationMatrix);
-        _mesh.draw(_shader);
+        _shaders.flat.setColor(_color).setTransformationProjectionMatrix(camera.projectionMatrix() * transformationMatrix);
+        _shaders.uniformBytes += sizeof(Color4) + sizeof(Matrix4);
+        _mesh.draw(_shaders.flat);
     }
 
-    Shaders::Flat3D& _shader;
+    UnsignedInt getShaderId() const override { return _shaders.flat.id(); }
+
+    SceneShaders& _shaders;
     GL::Mesh& _mesh;
     Color4 _color;
 };
 
-class ColoredDrawable : public SceneGraph::Drawable3D {
+class ColoredDrawable : public BoundedDrawable {
 public:
     explicit ColoredDrawable(Object3D& object,
-                             Shaders::Phong& shader,
+                             SceneShaders& shaders,
                              GL::Mesh& mesh,
                              const Color4& color,
                              SceneGraph::DrawableGroup3D& group) :
-        SceneGraph::Drawable3D{ object, &group },
-        _shader(shader), _mesh(mesh), _color{ color } {}
+        BoundedDrawable{ object, &group },
+        _shaders(shaders), _mesh(mesh), _color{ color } {}
 
     void draw(const Matrix4& transformationMatrix, SceneGraph::Camera3D& camera) override {
-        _shader.setDiffuseColor(_color)
-            .setLightPosition(camera.cameraMatrix().transformPoint({ -3.0f, 10.0f, 10.0f }))
+        if (_shaders.uniformBuffer) {
+            _shaders.uniformColored.setDiffuseColor(_color).setTransformationMatrix(transformationMatrix);
+            _shaders.uniformBytes += sizeof(Color4) + sizeof(Matrix4);
+            _mesh.draw(_shaders.uniformColored);
+            return;
+        }
+        _shaders.colored.setDiffuseColor(_color)
+            .setLightPosition(camera.cameraMatrix().transformPoint(LIGHT_POSITION))
             .setTransformationMatrix(transformationMatrix)
             .setNormalMatrix(transformationMatrix.rotationScaling())
             .setProjectionMatrix(camera.projectionMatrix());
-        _mesh.draw(_shader);
+        _shaders.uniformBytes += sizeof(Color4) + sizeof(Vector3) + sizeof(Matrix4) + sizeof(Matrix3x3) + sizeof(Matrix4);
+        _mesh.draw(_shaders.colored);
     }
 
-    Shaders::Phong& _shader;
+    UnsignedInt getShaderId() const override {
+        return _shaders.uniformBuffer ? _shaders.uniformColored.id() : _shaders.colored.id();
+    }
+
+    SceneShaders& _shaders;
     GL::Mesh& _mesh;
     Color4 _color;
 };
 
-class TexturedDrawable : public SceneGraph::Drawable3D {
+class TexturedDrawable : public BoundedDrawable {
 public:
     explicit TexturedDrawable(Object3D& object,
-                              Shaders::Phong& shader,
+                              SceneShaders& shaders,
                               GL::Mesh& mesh,
                               GL::Texture2D& texture,
                               SceneGraph::DrawableGroup3D& group) :
-        SceneGraph::Drawable3D{ object, &group },
-        _shader(shader), _mesh(mesh), _texture(texture) {}
+        BoundedDrawable{ object, &group },
+        _shaders(shaders), _mesh(mesh), _texture(texture) {}
 
     void draw(const Matrix4& transformationMatrix, SceneGraph::Camera3D& camera) override {
-        _shader.setLightPosition(camera.cameraMatrix().transformPoint({ -3.0f, 10.0f, 10.0f }))
+        if (_shaders.uniformBuffer) {
+            _shaders.uniformTextured.setTransformationMatrix(transformationMatrix).bindDiffuseTexture(_texture);
+            _shaders.uniformBytes += sizeof(Matrix4);
+            _mesh.draw(_shaders.uniformTextured);
+            return;
+        }
+        _shaders.textured.setLightPosition(camera.cameraMatrix().transformPoint(LIGHT_POSITION))
             .setTransformationMatrix(transformationMatrix)
             .setNormalMatrix(transformationMatrix.rotationScaling())
             .setProjectionMatrix(camera.projectionMatrix())
             .bindDiffuseTexture(_texture);
+        _shaders.uniformBytes += sizeof(Vector3) + sizeof(Matrix4) + sizeof(Matrix3x3) + sizeof(Matrix4);
 
-        _mesh.draw(_shader);
+        _mesh.draw(_shaders.textured);
+    }
+
+    UnsignedInt getShaderId() const override {
+        return _shaders.uniformBuffer ? _shaders.uniformTextured.id() : _shaders.textured.id();
     }
+    UnsignedInt getMaterialId() const override { return _texture.id(); }
 
-    Shaders::Phong& _shader;
+    SceneShaders& _shaders;
     GL::Mesh& _mesh;
     GL::Texture2D& _texture;
 };
@@ -241,9 +474,10 @@ private:
     Int _transformationProjectionMatrixUniform;
 };
 
-class CubeMap : public Object3D, SceneGraph::Drawable3D {
+class CubeMap : public Object3D, BoundedDrawable {
 public:
-    CubeMap(Object3D* parent, SceneGraph::DrawableGroup3D* group) : Object3D(parent), SceneGraph::Drawable3D(*this, group) {
+    CubeMap(Object3D* parent, SceneGraph::DrawableGroup3D* group, size_t& uniformBytes) :
+        Object3D(parent), BoundedDrawable(*this, group), _uniformBytes(uniformBytes) {
         auto& shared = Shared::get();
         auto& resourceManager = shared.resourceManager;
 
@@ -285,6 +519,8 @@ public:
             resourceManager.set<GL::AbstractShaderProgram>(_shader.key(), new CubeMapShader, ResourceDataState::Final,
                                                            ResourcePolicy::Manual);
         }
+        _shaderId = _shader->id();
+        _textureId = _texture->id();
     }
 
     void loadImage(const std::string& filename) {
@@ -325,14 +561,667 @@ public:
 
         _shader->setTransformationProjectionMatrix(camera.projectionMatrix() * Matrix4{ transformationMatrix.rotation() })
             .setTexture(*_texture);
+        _uniformBytes += sizeof(Matrix4);
+        // At the far plane, which still passes where the depth is cleared, and behind everything else
+        GL::Renderer::setDepthFunction(GL::Renderer::DepthFunction::LessOrEqual);
+        GL::Renderer::setDepthMask(false);
         _skybox->draw(*_shader);
+        GL::Renderer::setDepthMask(true);
+        GL::Renderer::setDepthFunction(GL::Renderer::DepthFunction::Less);
     }
 
+    Pass getPass() const override { return Pass::Sky; }
+    UnsignedInt getShaderId() const override { return _shaderId; }
+    UnsignedInt getMaterialId() const override { return _textureId; }
+
+    // See `SceneShaders::uniformBytes`
+    size_t& _uniformBytes;
     Resource<GL::Mesh> _skybox;
     Resource<GL::CubeMapTexture> _texture;
     Resource<GL::AbstractShaderProgram, CubeMapShader> _shader;
+    // For the sort keys, as resources can't be accessed from const methods
+    UnsignedInt _shaderId{ 0 };
+    UnsignedInt _textureId{ 0 };
+};
+
+// Phong shading of every instance of a mesh in one draw, with the world transform and diffuse color of each instance
+// in per-instance attributes, see `InstancedDrawable`.  Lit like `Shaders::Phong`, with the light in world space, and
+// the eyes and the light read from the frame's uniform buffer.
+// A stereo shader draws every instance once per eye, into a viewport covering both eyes, so its meshes need the
+// per-instance attributes to advance every other instance
+class InstancedPhongShader : public GL::AbstractShaderProgram {
+public:
+    using Position = Shaders::Generic3D::Position;
+    using Normal = Shaders::Generic3D::Normal;
+    using TextureCoordinates = Shaders::Generic3D::TextureCoordinates;
+    // Past the locations of the generic attributes
+    using InstanceTransformation = GL::Attribute<8, Matrix4>;
+    using InstanceColor = GL::Attribute<12, Vector4>;
+
+    explicit InstancedPhongShader(bool textured, bool stereo) : _stereo(stereo) {
+        GL::Shader vert(GL::Version::GL450, GL::Shader::Type::Vertex);
+        GL::Shader frag(GL::Version::GL450, GL::Shader::Type::Fragment);
+        if (textured) {
+            vert.addSource("#define TEXTURED\n");
+            frag.addSource("#define TEXTURED\n");
+        }
+        if (stereo) {
+            vert.addSource("#define STEREO\n");
+        }
+        const auto frameUniforms = assets::getAssetContents("shaders/FrameUniforms.glsl");
+        vert.addSource(frameUniforms).addSource(assets::getAssetContents("shaders/InstancedPhongShader.vert"));
+        frag.addSource(frameUniforms).addSource(assets::getAssetContents("shaders/InstancedPhongShader.frag"));
+        if (!GL::Shader::compile({ vert, frag })) {
+            throw std::runtime_error("Failed to compile shader");
+        }
+        attachShaders({ vert, frag });
+        bindAttributeLocation(Position::Location, "position");
+        bindAttributeLocation(Normal::Location, "normal");
+        if (textured) {
+            bindAttributeLocation(TextureCoordinates::Location, "textureCoordinates");
+        }
+        bindAttributeLocation(InstanceTransformation::Location, "instanceTransformation");
+        bindAttributeLocation(InstanceColor::Location, "instanceColor");
+        if (!link()) {
+            throw std::runtime_error("Failed to compile shader");
+        }
+        if (!stereo) {
+            _eyeIndexUniform = uniformLocation("eyeIndex");
+        }
+        _ambientColorUniform = uniformLocation("ambientColor");
+        _specularColorUniform = uniformLocation("specularColor");
+        _shininessUniform = uniformLocation("shininess");
+        if (textured) {
+            setUniform(uniformLocation("diffuseTexture"), 0);
+        }
+    }
+
+    // The meshes of the instances are drawn this many times per instance
+    UnsignedInt getViewCount() const { return _stereo ? 2 : 1; }
+
+    // Which eye of the uniform buffer a mono shader draws
+    InstancedPhongShader& setEyeIndex(UnsignedInt eyeIndex) {
+        if (!_stereo) {
+            setUniform(_eyeIndexUniform, (Int)eyeIndex);
+            _eyeIndex = eyeIndex;
+        }
+        return *this;
+    }
+
+    // Zero for a stereo shader, which draws both
+    UnsignedInt getEyeIndex() const { return _eyeIndex; }
+
+    InstancedPhongShader& setAmbientColor(const Color4& color) {
+        setUniform(_ambientColorUniform, color);
+        return *this;
+    }
+
+    InstancedPhongShader& setSpecularColor(const Color4& color) {
+        setUniform(_specularColorUniform, color);
+        return *this;
+    }
+
+    InstancedPhongShader& setShininess(Float shininess) {
+        setUniform(_shininessUniform, shininess);
+        return *this;
+    }
+
+    InstancedPhongShader& bindDiffuseTexture(GL::Texture2D& texture) {
+        texture.bind(0);
+        return *this;
+    }
+
+private:
+    const bool _stereo;
+    UnsignedInt _eyeIndex{ 0 };
+    Int _eyeIndexUniform{ -1 };
+    Int _ambientColorUniform;
+    Int _specularColorUniform;
+    Int _shininessUniform;
+};
+
+// The per-instance attributes of every instance of one mesh, or with static batching of every mesh, ordered so that
+// the instances drawn together are contiguous.  The world space bounds of the instances and of their groups are only
+// updated when the transformation of one of the instances has changed.  The instances are culled one by one, and
+// those left are compacted, group by group, into what's uploaded, which is only uploaded again when that changes
+struct InstanceBuffer {
+    struct Instance {
+        Matrix4 transformation;
+        Color4 color;
+    };
+
+    // The instances drawn by one draw, or one command of a multi-draw
+    struct Group {
+        size_t begin;
+        size_t count;
+        Range3D meshBounds;
+        // Of all the instances, in world space
+        Range3D bounds;
+        // Whose bounds are kept up to date, if the group is drawn by a drawable
+        BoundedDrawable* drawable;
+        // The instances left after culling, in the uploaded buffer, for each eye
+        std::array<UnsignedInt, 2> frameBegin{};
+        std::array<UnsignedInt, 2> frameCount{};
+    };
+
+    GL::Buffer buffer;
+    std::vector<Instance> instances;
+    std::vector<Object3D*> objects;
+    std::vector<Group> groups;
+    bool dirty{ true };
+    // Indexed like `instances` and `groups`.  Bit `set` of a mask is whether the set of draws draws it
+    BoxCuller instanceBounds;
+    BoxCuller groupBounds;
+    std::vector<uint8_t> instanceMasks;
+    std::vector<uint8_t> groupMasks;
+    // One set of draws per eye when the eyes are culled separately, otherwise one for both
+    size_t setCount{ 1 };
+    // What `buffer` holds, one set after the other
+    std::vector<Instance> frameInstances;
+    // What `frameInstances` were compacted from, to only compact them again when it changes
+    std::vector<uint8_t> compactedMasks;
+    size_t compactedSetCount{ 0 };
+    bool moved{ true };
+
+    void update() {
+        if (!dirty) {
+            return;
+        }
+        // Cleaning the objects passes their new absolute transformations to their `InstanceFeature`s
+        for (auto* object : objects) {
+            object->setClean();
+        }
+        instanceBounds.resize(instances.size());
+        groupBounds.resize(groups.size());
+        for (size_t g = 0; g < groups.size(); ++g) {
+            auto& group = groups[g];
+            for (size_t i = group.begin; i < group.begin + group.count; ++i) {
+                instanceBounds.set(i, group.meshBounds, instances[i].transformation);
+                group.bounds = i == group.begin ? instanceBounds.get(i) : Math::join(group.bounds, instanceBounds.get(i));
+            }
+            groupBounds.set(g, group.bounds);
+            if (group.drawable) {
+                group.drawable->setBounds(group.bounds, BoundedDrawable::Space::World);
+            }
+        }
+        dirty = false;
+        moved = true;
+    }
+
+    // Culls the groups, then the instances of the groups left, against `stereoFrustum` and, when given, against each
+    // of `eyeFrustums`, which then get a set of draws each.  Nothing is culled without a stereo frustum.  Returns the
+    // instances culled for both eyes
+    size_t cull(const Frustum* stereoFrustum, const std::array<Frustum, 2>* eyeFrustums) {
+        static const uint8_t ALL_SETS = 3;
+        setCount = eyeFrustums ? 2 : 1;
+        groupMasks.assign(groups.size(), ALL_SETS);
+        instanceMasks.resize(instances.size());
+        if (stereoFrustum) {
+            groupBounds.cull(*stereoFrustum, 0, groups.size(), ALL_SETS, groupMasks.data());
+        }
+        if (eyeFrustums) {
+            for (size_t set = 0; set < setCount; ++set) {
+                groupBounds.cull((*eyeFrustums)[set], 0, groups.size(), (uint8_t)(1 << set), groupMasks.data());
+            }
+        }
+        size_t culled = 0;
+        for (size_t g = 0; g < groups.size(); ++g) {
+            const auto& group = groups[g];
+            auto begin = group.begin;
+            auto end = group.begin + group.count;
+            std::fill(instanceMasks.begin() + begin, instanceMasks.begin() + end, groupMasks[g]);
+            // The instances of a culled group are culled with it, and a lone instance's bounds are the group's
+            if (groupMasks[g] != 0 && group.count > 1) {
+                if (stereoFrustum) {
+                    instanceBounds.cull(*stereoFrustum, begin, end, ALL_SETS, instanceMasks.data());
+                }
+                if (eyeFrustums) {
+                    for (size_t set = 0; set < setCount; ++set) {
+                        instanceBounds.cull((*eyeFrustums)[set], begin, end, (uint8_t)(1 << set), instanceMasks.data());
+                    }
+                }
+            }
+            culled += (size_t)std::count(instanceMasks.begin() + begin, instanceMasks.begin() + end, 0);
+        }
+        return culled;
+    }
+
+    // Packs the instances each set draws together, group after group, and uploads them
+    void compact() {
+        if (!moved && setCount == compactedSetCount && instanceMasks == compactedMasks) {
+            return;
+        }
+        frameInstances.clear();
+        for (size_t set = 0; set < setCount; ++set) {
+            for (auto& group : groups) {
+                group.frameBegin[set] = (UnsignedInt)frameInstances.size();
+                for (size_t i = group.begin; i < group.begin + group.count; ++i) {
+                    if (0 != (instanceMasks[i] & (1 << set))) {
+                        frameInstances.push_back(instances[i]);
+                    }
+                }
+                group.frameCount[set] = (UnsignedInt)frameInstances.size() - group.frameBegin[set];
+            }
+        }
+        // Both eyes draw the one set
+        if (setCount == 1) {
+            for (auto& group : groups) {
+                group.frameBegin[1] = group.frameBegin[0];
+                group.frameCount[1] = group.frameCount[0];
+            }
+        }
+        buffer.setData({ frameInstances.data(), frameInstances.size() * sizeof(Instance) }, GL::BufferUsage::DynamicDraw);
+        compactedMasks = instanceMasks;
+        compactedSetCount = setCount;
+        moved = false;
+    }
+};
+
+// Tracks the absolute transformation of an instanced object through the scene graph's dirty flags
+class InstanceFeature : public SceneGraph::AbstractFeature3D {
+public:
+    InstanceFeature(Object3D& object, InstanceBuffer& buffer, size_t index) :
+        SceneGraph::AbstractFeature3D{ object }, _buffer(buffer), _index(index) {
+        setCachedTransformations(SceneGraph::CachedTransformation::Absolute);
+    }
+
+private:
+    void markDirty() override { _buffer.dirty = true; }
+    void clean(const Matrix4& absoluteTransformationMatrix) override {
+        _buffer.instances[_index].transformation = absoluteTransformationMatrix;
+    }
+
+    InstanceBuffer& _buffer;
+    const size_t _index;
+};
+
+// Draws the instances of one group of an instance buffer left after culling, for the eye the shader is set to.  The
+// instances are in world space, so the transformation of the object this is attached to doesn't apply to them, and
+// the eyes come from the uniform buffer rather than the camera.  Drawables with a stereo shader are drawn once for
+// both eyes, with `draw()`, rather than by the cameras
+class InstancedDrawable : public BoundedDrawable {
+public:
+    explicit InstancedDrawable(Object3D& object,
+                               InstancedPhongShader& shader,
+                               GL::Mesh& mesh,
+                               GL::Texture2D* texture,
+                               const InstanceBuffer& buffer,
+                               size_t groupIndex,
+                               SceneGraph::DrawableGroup3D& group) :
+        BoundedDrawable{ object, &group },
+        _shader(shader), _mesh(mesh), _texture(texture), _buffer(buffer), _groupIndex(groupIndex) {}
+
+    void draw(const Matrix4&, SceneGraph::Camera3D&) override { draw(); }
+
+    void draw() {
+        if (_texture) {
+            _shader.bindDiffuseTexture(*_texture);
+        }
+        const auto& group = _buffer.groups[_groupIndex];
+        auto eyeIndex = _shader.getEyeIndex();
+        // The base instance isn't divided by the attribute divisor, so it's the same for mono and stereo shaders
+        _mesh.setBaseInstance(group.frameBegin[eyeIndex])
+            .setInstanceCount(group.frameCount[eyeIndex] * _shader.getViewCount());
+        _mesh.draw(_shader);
+    }
+
+    bool isEmpty(uint32_t eyeIndex) const override { return 0 == _buffer.groups[_groupIndex].frameCount[eyeIndex]; }
+    UnsignedInt getShaderId() const override { return _shader.id(); }
+    UnsignedInt getMaterialId() const override { return _texture ? _texture->id() : 0; }
+
+    InstancedPhongShader& _shader;
+    GL::Mesh& _mesh;
+    GL::Texture2D* _texture;
+    const InstanceBuffer& _buffer;
+    const size_t _groupIndex;
+};
+
+// The meshes of a loaded model packed into one vertex and one index buffer behind one vertex array, with the
+// instances of all of them in one instance buffer, so that all the nodes drawn with the same shader and texture are
+// drawn with one glMultiDrawElementsIndirect, rather than a draw and a vertex array bind per mesh.  Each group of
+// instances gets one command, which is rewritten every frame to draw the instances of the group left after culling
+struct StaticBatch {
+    // Every mesh gets texture coordinates, zero if it has none, so that they all share the one layout
+    struct Vertex {
+        Vector3 position;
+        Vector3 normal;
+        Vector2 textureCoordinates;
+    };
+
+    // Where a mesh is in the packed buffers
+    struct MeshRange {
+        UnsignedInt firstIndex{ 0 };
+        UnsignedInt indexCount{ 0 };
+        Int baseVertex{ 0 };
+    };
+
+    // As glMultiDrawElementsIndirect reads them
+    struct DrawCommand {
+        UnsignedInt count;
+        UnsignedInt instanceCount;
+        UnsignedInt firstIndex;
+        Int baseVertex;
+        UnsignedInt baseInstance;
+    };
+
+    // Consecutive commands drawn with the same shader and texture, by one multi-draw
+    struct MaterialGroup {
+        InstancedPhongShader* shader;
+        GL::Texture2D* texture;
+        size_t firstCommand;
+        size_t commandCount;
+        // See `SortKey`
+        uint64_t sortKey;
+        // Whether any of the commands of each set has instances left this frame
+        std::array<bool, 2> visible;
+    };
+
+    // Only kept until uploaded
+    std::vector<Vertex> vertices;
+    std::vector<UnsignedInt> indices;
+    // Indexed by mesh
+    std::vector<MeshRange> meshRanges;
+    InstanceBuffer instances;
+    // One per group of `instances`, with every instance of the group
+    std::vector<DrawCommand> commands;
+    std::vector<MaterialGroup> materialGroups;
+    // The commands drawn this frame, one set per eye for mono shaders, or one set for both eyes for stereo ones
+    std::vector<DrawCommand> frameCommands;
+    GL::Buffer vertexBuffer, indexBuffer, commandBuffer;
+    GL::Mesh mesh;
+
+    void addMesh(UnsignedInt meshId, const Trade::MeshData3D& meshData) {
+        if (meshRanges.size() <= meshId) {
+            meshRanges.resize(meshId + 1);
+        }
+        auto& range = meshRanges[meshId];
+        range.firstIndex = (UnsignedInt)indices.size();
+        range.baseVertex = (Int)vertices.size();
+        const auto& positions = meshData.positions(0);
+        const auto& normals = meshData.normals(0);
+        const bool textured = meshData.hasTextureCoords2D();
+        for (size_t i = 0; i < positions.size(); ++i) {
+            vertices.push_back({ positions[i], normals[i], textured ? meshData.textureCoords2D(0)[i] : Vector2{} });
+        }
+        if (meshData.isIndexed()) {
+            indices.insert(indices.end(), meshData.indices().begin(), meshData.indices().end());
+        } else {
+            for (UnsignedInt i = 0; i < (UnsignedInt)positions.size(); ++i) {
+                indices.push_back(i);
+            }
+        }
+        range.indexCount = (UnsignedInt)indices.size() - range.firstIndex;
+    }
+
+    // `viewCount` is how many times each instance is drawn, see `InstancedPhongShader::getViewCount()`
+    void upload(UnsignedInt viewCount) {
+        vertexBuffer.setData({ vertices.data(), vertices.size() * sizeof(Vertex) }, GL::BufferUsage::StaticDraw);
+        indexBuffer.setData({ indices.data(), indices.size() * sizeof(UnsignedInt) }, GL::BufferUsage::StaticDraw);
+        mesh.setPrimitive(MeshPrimitive::Triangles)
+            .setCount((Int)indices.size())
+            .addVertexBuffer(vertexBuffer, 0, InstancedPhongShader::Position{}, InstancedPhongShader::Normal{},
+                             InstancedPhongShader::TextureCoordinates{})
+            .setIndexBuffer(indexBuffer, 0, MeshIndexType::UnsignedInt)
+            .addVertexBufferInstanced(instances.buffer, viewCount, 0, InstancedPhongShader::InstanceTransformation{},
+                                      InstancedPhongShader::InstanceColor{});
+        vertices = {};
+        indices = {};
+    }
+
+    // Points each command at the instances of its group compacted for each set.  Stereo commands draw each instance
+    // for both eyes
+    void updateCommands(bool stereo) {
+        const size_t setCount = stereo ? 1 : 2;
+        frameCommands.resize(commands.size() * setCount);
+        for (auto& group : materialGroups) {
+            group.visible = { false, false };
+        }
+        for (size_t set = 0; set < setCount; ++set) {
+            for (auto& group : materialGroups) {
+                for (size_t i = group.firstCommand; i < group.firstCommand + group.commandCount; ++i) {
+                    auto command = commands[i];
+                    const auto& instanceGroup = instances.groups[i];
+                    command.baseInstance = instanceGroup.frameBegin[set];
+                    command.instanceCount = instanceGroup.frameCount[set] * (UnsignedInt)(stereo ? 2 : 1);
+                    group.visible[set] = group.visible[set] || command.instanceCount != 0;
+                    frameCommands[set * commands.size() + i] = command;
+                }
+            }
+        }
+        commandBuffer.setData({ frameCommands.data(), frameCommands.size() * sizeof(DrawCommand) },
+                              GL::BufferUsage::DynamicDraw);
+    }
+
+    // Magnum has no indirect draws, so this is raw GL, which the caller brackets as external to Magnum's state
+    // tracking.  Returns the multi-draws issued
+    uint32_t draw(size_t set) {
+        uint32_t draws = 0;
+        glBindVertexArray(mesh.id());
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer.id());
+        for (const auto& group : materialGroups) {
+            if (!group.visible[set]) {
+                continue;
+            }
+            glUseProgram(group.shader->id());
+            if (group.texture) {
+                glBindTextureUnit(0, group.texture->id());
+            }
+            auto offset = (set * commands.size() + group.firstCommand) * sizeof(DrawCommand);
+            glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, reinterpret_cast<const void*>(offset),
+                                        (GLsizei)group.commandCount, 0);
+            ++draws;
+        }
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        glBindVertexArray(0);
+        return draws;
+    }
 };
 
+static void setWorldBounds(BoxCuller& boxes, size_t index, const BoundedDrawable& drawable, const Matrix4& world) {
+    switch (drawable.getBoundsSpace()) {
+        case BoundedDrawable::Space::Object:
+            boxes.set(index, drawable.getBounds(), world);
+            break;
+        case BoundedDrawable::Space::World:
+            boxes.set(index, drawable.getBounds());
+            break;
+        default:
+            boxes.setUnbounded(index);
+            break;
+    }
+}
+
+class BoundsFeature;
+
+// The objects of a drawable group's drawables and their ancestors, in depth first order, so that every subtree is a
+// contiguous range of nodes.  Each node has world space bounds enclosing its object's drawables and its whole subtree,
+// so that a subtree outside a frustum is culled with one test, without testing anything in it.  The bounds are only
+// joined again for the objects that moved and their ancestors: the scene graph's dirty flags reach a `BoundsFeature`
+// on each object, which passes them up the hierarchy
+struct BoundsHierarchy {
+    struct Node {
+        Object3D* object;
+        // -1 for the children of the scene
+        Int parent;
+        // One past the last node of the subtree
+        UnsignedInt subtreeEnd;
+        // The object's drawables, in `nodeDrawables`
+        UnsignedInt firstDrawable;
+        UnsignedInt drawableCount;
+        // The object's absolute transformation, cached by its `BoundsFeature`
+        Matrix4 world;
+        // The object's drawables need their bounds transforming again
+        bool moved{ true };
+        // The subtree's bounds need joining again
+        bool dirty{ true };
+    };
+
+    // Indexed like `nodes`
+    std::vector<Node> nodes;
+    BoxCuller bounds;
+    std::vector<BoundsFeature*> features;
+    // The indices in the drawable group of each node's drawables
+    std::vector<UnsignedInt> nodeDrawables;
+    // Indexed like the drawable group
+    std::vector<UnsignedInt> drawableNodes;
+    // With drawables whose world space bounds change without their object moving, so joined again every update
+    std::vector<UnsignedInt> worldBoundedNodes;
+    bool dirty{ true };
+    // Built for a drawable group that has changed since
+    bool stale{ true };
+
+    void build(SceneGraph::DrawableGroup3D& drawables);
+    // The features are owned by their objects, so this has to be called while the objects are still alive
+    void clear();
+
+    // The object of `node` moved, and so did the objects below it, whose features are told separately
+    void markDirty(UnsignedInt node) {
+        nodes[node].moved = true;
+        for (Int i = (Int)node; i != -1 && !nodes[i].dirty; i = nodes[i].parent) {
+            nodes[i].dirty = true;
+        }
+        dirty = true;
+    }
+
+    // Transforms the bounds of the drawables of the objects that moved into `drawableBounds`, indexed like the drawable
+    // group, and joins the bounds of their subtrees back up to the roots.  Going backwards through the nodes, every
+    // child is joined before its parent
+    void update(SceneGraph::DrawableGroup3D& drawables, BoxCuller& drawableBounds) {
+        for (auto node : worldBoundedNodes) {
+            markDirty(node);
+        }
+        if (!dirty) {
+            return;
+        }
+        for (size_t n = nodes.size(); n-- > 0;) {
+            auto& node = nodes[n];
+            if (!node.dirty) {
+                continue;
+            }
+            auto begin = nodeDrawables.begin() + node.firstDrawable;
+            auto end = begin + node.drawableCount;
+            if (node.moved) {
+                // Passes the new absolute transformation to the node's feature
+                node.object->setClean();
+                for (auto itr = begin; itr != end; ++itr) {
+                    setWorldBounds(drawableBounds, *itr, static_cast<BoundedDrawable&>(drawables[*itr]), node.world);
+                }
+                node.moved = false;
+            }
+            Range3D box;
+            bool empty = true;
+            auto join = [&](const Range3D& other) {
+                box = empty ? other : Math::join(box, other);
+                empty = false;
+            };
+            for (auto itr = begin; itr != end; ++itr) {
+                join(drawableBounds.get(*itr));
+            }
+            for (auto child = (UnsignedInt)n + 1; child < node.subtreeEnd; child = nodes[child].subtreeEnd) {
+                join(bounds.get(child));
+            }
+            bounds.set(n, box);
+            node.dirty = false;
+        }
+        dirty = false;
+    }
+};
+
+// Tracks the absolute transformation of an object of a bounds hierarchy through the scene graph's dirty flags
+class BoundsFeature : public SceneGraph::AbstractFeature3D {
+public:
+    BoundsFeature(Object3D& object, BoundsHierarchy& hierarchy, UnsignedInt node) :
+        SceneGraph::AbstractFeature3D{ object }, _hierarchy(hierarchy), _node(node) {
+        setCachedTransformations(SceneGraph::CachedTransformation::Absolute);
+    }
+
+private:
+    void markDirty() override { _hierarchy.markDirty(_node); }
+    void clean(const Matrix4& absoluteTransformationMatrix) override {
+        _hierarchy.nodes[_node].world = absoluteTransformationMatrix;
+    }
+
+    BoundsHierarchy& _hierarchy;
+    const UnsignedInt _node;
+};
+
+void BoundsHierarchy::build(SceneGraph::DrawableGroup3D& drawables) {
+    clear();
+    // Walking up from each drawable's object to the first object already known, or to the scene
+    std::unordered_map<Object3D*, std::vector<UnsignedInt>> objectDrawables;
+    std::unordered_map<Object3D*, std::vector<Object3D*>> children;
+    std::unordered_set<Object3D*> known;
+    std::vector<Object3D*> roots;
+    for (size_t i = 0; i < drawables.size(); ++i) {
+        auto* object = static_cast<Object3D*>(&drawables[i].object());
+        objectDrawables[object].push_back((UnsignedInt)i);
+        for (auto* child = object; known.insert(child).second;) {
+            auto* parent = child->parent();
+            if (!parent || parent->isScene()) {
+                roots.push_back(child);
+                break;
+            }
+            children[parent].push_back(child);
+            child = parent;
+        }
+    }
+
+    drawableNodes.resize(drawables.size());
+    std::vector<std::pair<Object3D*, Int>> stack;
+    for (auto itr = roots.rbegin(); itr != roots.rend(); ++itr) {
+        stack.emplace_back(*itr, -1);
+    }
+    while (!stack.empty()) {
+        auto [object, parent] = stack.back();
+        stack.pop_back();
+        auto index = (UnsignedInt)nodes.size();
+        Node node{ object, parent, index + 1, (UnsignedInt)nodeDrawables.size(), 0, Matrix4{} };
+        bool worldBounded = false;
+        for (auto drawable : objectDrawables[object]) {
+            nodeDrawables.push_back(drawable);
+            drawableNodes[drawable] = index;
+            ++node.drawableCount;
+            auto space = static_cast<BoundedDrawable&>(drawables[drawable]).getBoundsSpace();
+            worldBounded = worldBounded || space != BoundedDrawable::Space::Object;
+        }
+        if (worldBounded) {
+            worldBoundedNodes.push_back(index);
+        }
+        nodes.push_back(node);
+        const auto& objectChildren = children[object];
+        for (auto itr = objectChildren.rbegin(); itr != objectChildren.rend(); ++itr) {
+            stack.emplace_back(*itr, (Int)index);
+        }
+    }
+    for (size_t n = nodes.size(); n-- > 0;) {
+        if (nodes[n].parent != -1) {
+            auto& parent = nodes[nodes[n].parent];
+            parent.subtreeEnd = std::max(parent.subtreeEnd, nodes[n].subtreeEnd);
+        }
+    }
+
+    bounds.resize(nodes.size());
+    for (UnsignedInt n = 0; n < nodes.size(); ++n) {
+        features.push_back(new BoundsFeature{ *nodes[n].object, *this, n });
+        // Makes sure the feature is cleaned with the current transformation
+        nodes[n].object->setDirty();
+    }
+    dirty = true;
+    stale = false;
+}
+
+void BoundsHierarchy::clear() {
+    for (auto* feature : features) {
+        delete feature;
+    }
+    features.clear();
+    nodes.clear();
+    nodeDrawables.clear();
+    drawableNodes.clear();
+    worldBoundedNodes.clear();
+    stale = true;
+}
+
 struct AABB {
     Vector3 scale;
     Vector3 corner;
@@ -373,6 +1262,27 @@ using namespace xr_examples::magnum;
 using namespace xr_examples::magnum::impl;
 
 struct Scene::Private {
+    using Clock = std::chrono::steady_clock;
+    using DrawList = std::vector<std::pair<std::reference_wrapper<SceneGraph::Drawable3D>, Matrix4>>;
+
+    // A drawable ready to be submitted for both eyes.  Building these only reads the scene graph, so it's split
+    // across threads, and only replaying them, which issues the GL calls, is left to the GL thread
+    static constexpr uint8_t LEFT_EYE = 1;
+    static constexpr uint8_t RIGHT_EYE = 2;
+    static constexpr uint8_t BOTH_EYES = LEFT_EYE | RIGHT_EYE;
+
+    struct DrawPacket {
+        // See `SortKey`
+        uint64_t sortKey{ 0 };
+        // In the drawable group, the order the draws are submitted in without sorting
+        uint32_t index{ 0 };
+        SceneGraph::Drawable3D* drawable{ nullptr };
+        // The eyes whose frustums the drawable isn't culled from
+        uint8_t eyes{ BOTH_EYES };
+        // Relative to each eye's camera
+        std::array<Matrix4, 2> transformations;
+    };
+
     Scene3D scene;
     SceneGraph::DrawableGroup3D drawables;
     Object3D* playerRoot{ new Object3D(&scene) };
@@ -383,6 +1293,8 @@ struct Scene::Private {
         Object3D* cameraObject{ new Object3D() };
         // Holds the camera projection and executes the rendering
         SceneGraph::Camera3D* camera{ new SceneGraph::Camera3D{ *cameraObject } };
+        // For culling.  Matches the initial projection of the camera until the eyes are updated
+        xr::Fovf fov{ -0.3054f, 0.3054f, 0.3054f, -0.3054f };
     };
     std::array<EyeData, 2> eyesData;
 
@@ -396,14 +1308,58 @@ struct Scene::Private {
     };
     std::array<HandData, 2> handsData;
 
-    Shaders::Phong coloredShader, texturedShader{ Shaders::Phong::Flag::DiffuseTexture };
-    Shaders::Flat3D flatShader;
+    SceneShaders shaders;
+    InstancedPhongShader instancedColoredShader{ false, false }, instancedTexturedShader{ true, false };
+    InstancedPhongShader stereoColoredShader{ false, true }, stereoTexturedShader{ true, true };
+    GL::Buffer frameUniformBuffer;
+
+    // A mesh node of the loaded model, waiting to be grouped with the other nodes drawn the same way
+    struct PendingInstance {
+        Object3D* object;
+        UnsignedInt mesh;
+        GL::Texture2D* texture;
+        Color4 color;
+    };
+    bool instancing{ true };
+    bool stereoInstancing{ false };
+    std::vector<PendingInstance> pendingInstances;
+    std::vector<std::unique_ptr<InstanceBuffer>> instanceBuffers;
+    // The instanced drawables of a stereo instanced model, which aren't drawn by the cameras
+    SceneGraph::DrawableGroup3D stereoDrawables;
+    // Takes the place of the instanced drawables of the loaded model, when set before loading it
+    bool batching{ true };
+    std::unique_ptr<StaticBatch> batch;
 
     std::vector<AABB> meshExtents;
+    // Whether each mesh of the model was loaded.  The meshes are only compiled on their own when not batching
+    std::vector<bool> loadedMeshes;
     Containers::Array<Containers::Optional<GL::Mesh>> meshes;
     Containers::Array<Containers::Optional<GL::Texture2D>> textures;
     Containers::Array<Containers::Optional<Trade::PhongMaterialData>> materials;
 
+    ParallelFor traversal;
+    Culling culling{ Culling::Stereo };
+    // Copied from the scene by `updateEyes()`
+    float nearZ{ 0.01f };
+    float farZ{ 1000.0f };
+    // Of the drawables drawn by the cameras, rebuilt when they change
+    BoundsHierarchy boundsHierarchy;
+    // Indexed like the hierarchy's nodes, the eyes each subtree isn't culled from
+    std::vector<uint8_t> nodeMasks;
+    // Indexed like `drawables`, and written by the traversal threads for their own range of drawables, except for the
+    // bounds, which the hierarchy keeps up to date
+    std::vector<Matrix4> worldTransforms;
+    BoxCuller worldBounds;
+    std::vector<uint8_t> eyeMasks;
+    // One list per traversal thread, merged and sorted into `drawList`, which is then split per eye for the cameras
+    std::vector<std::vector<DrawPacket>> threadPackets;
+    std::vector<DrawPacket> drawList;
+    std::array<DrawList, 2> eyeDrawLists;
+    // The stereo instanced drawables with instances inside the stereo frustum
+    std::vector<DrawPacket> stereoDrawList;
+    bool drawSorting{ true };
+    Stats stats;
+
     Private() {
         setupImporters();
         setupRendering();
@@ -431,8 +1387,16 @@ struct Scene::Private {
     void setupRendering() {
         GL::Renderer::enable(GL::Renderer::Feature::DepthTest);
         GL::Renderer::enable(GL::Renderer::Feature::FaceCulling);
-        coloredShader.setAmbientColor(0x111111_rgbf).setSpecularColor(0xffffff_rgbf).setShininess(80.0f);
-        texturedShader.setAmbientColor(0x111111_rgbf).setSpecularColor(0x111111_rgbf).setShininess(80.0f);
+        shaders.colored.setAmbientColor(0x111111_rgbf).setSpecularColor(0xffffff_rgbf).setShininess(80.0f);
+        shaders.textured.setAmbientColor(0x111111_rgbf).setSpecularColor(0x111111_rgbf).setShininess(80.0f);
+        shaders.uniformColored.setAmbientColor(0x111111_rgbf).setSpecularColor(0xffffff_rgbf).setShininess(80.0f);
+        shaders.uniformTextured.setAmbientColor(0x111111_rgbf).setSpecularColor(0x111111_rgbf).setShininess(80.0f);
+        for (auto* shader : { &instancedColoredShader, &stereoColoredShader }) {
+            shader->setAmbientColor(0x111111_rgbf).setSpecularColor(0xffffff_rgbf).setShininess(80.0f);
+        }
+        for (auto* shader : { &instancedTexturedShader, &stereoTexturedShader }) {
+            shader->setAmbientColor(0x111111_rgbf).setSpecularColor(0x111111_rgbf).setShininess(80.0f);
+        }
     }
 
     void setupBaseScene() {
@@ -447,7 +1411,8 @@ struct Scene::Private {
     }
 
     void setupCubemap(const std::string cubemapPrefix) {
-        cubemap = new CubeMap(&scene, &drawables);
+        boundsHierarchy.clear();
+        cubemap = new CubeMap(&scene, &drawables, shaders.uniformBytes);
         cubemap->scale(Vector3(20.0f));
         cubemap->loadImage(cubemapPrefix);
     }
@@ -462,12 +1427,15 @@ struct Scene::Private {
 
             handData.gripRoot = new Object3D(playerRoot);
             handData.gripRoot->setParent(playerRoot);
-            handData.gripDrawable = new ColoredDrawable(*handData.gripRoot, coloredShader, *cubeMesh, color, drawables);
+            handData.gripDrawable = new ColoredDrawable(*handData.gripRoot, shaders, *cubeMesh, color, drawables);
+            handData.gripDrawable->setBounds(CUBE_BOUNDS);
 
             handData.aimRoot = new Object3D(playerRoot);
             handData.aimRoot->setParent(playerRoot);
-            handData.aimDrawable = new ColoredDrawable(*handData.aimRoot, coloredShader, *cubeMesh, color, drawables);
-            handData.lineDrawable = new FlatDrawable(*handData.aimRoot, flatShader, *lineMesh, color, drawables);
+            handData.aimDrawable = new ColoredDrawable(*handData.aimRoot, shaders, *cubeMesh, color, drawables);
+            handData.aimDrawable->setBounds(CUBE_BOUNDS);
+            handData.lineDrawable = new FlatDrawable(*handData.aimRoot, shaders, *lineMesh, color, drawables);
+            handData.lineDrawable->setBounds(Range3D{ { 0.0f, 0.0f, -10000.0f }, { 0.0f, 0.0f, 0.0f } });
         });
     }
 
@@ -477,6 +1445,7 @@ struct Scene::Private {
         if (!importer->openFile(filename)) {
             throw std::runtime_error("Unable to open scene file");
         }
+        boundsHierarchy.clear();
 
         textures = Containers::Array<Containers::Optional<GL::Texture2D>>{ importer->textureCount() };
         for (UnsignedInt i = 0; i != importer->textureCount(); ++i) {
@@ -528,6 +1497,10 @@ struct Scene::Private {
 
         meshes = Containers::Array<Containers::Optional<GL::Mesh>>{ importer->mesh3DCount() };
         meshExtents.resize(importer->mesh3DCount());
+        loadedMeshes.assign(importer->mesh3DCount(), false);
+        if (batching) {
+            batch = std::make_unique<StaticBatch>();
+        }
         for (UnsignedInt i = 0; i != importer->mesh3DCount(); ++i) {
             Debug{} << "Importing mesh" << i << importer->mesh3DName(i).c_str();
 
@@ -543,8 +1516,13 @@ struct Scene::Private {
                     aabb += v;
                 }
             }
-            /* Compile the mesh */
-            meshes[i] = MeshTools::compile(*meshData);
+            loadedMeshes[i] = true;
+            if (batch) {
+                batch->addMesh(i, *meshData);
+            } else {
+                /* Compile the mesh */
+                meshes[i] = MeshTools::compile(*meshData);
+            }
         }
 
         auto* object = new Object3D{ modelsRoot };
@@ -559,10 +1537,15 @@ struct Scene::Private {
             for (UnsignedInt objectId : sceneData->children3D()) {
                 modelExtent = addObject(*importer, object, objectId);
             }
-        } else if (!meshes.empty() && meshes[0]) {
-            new ColoredDrawable{ *object, coloredShader, *meshes[0], 0xffffff_rgbf, drawables };
+        } else if (!loadedMeshes.empty() && loadedMeshes[0]) {
+            addMeshDrawable(*object, 0, -1);
             modelExtent = meshExtents[0];
         }
+        if (batch) {
+            buildBatch();
+        } else {
+            buildInstances(*object);
+        }
 
         // Scale down the root object to a reasonable size
         float modelScale = modelExtent.scaleForFit(0.5f);
@@ -578,39 +1561,506 @@ struct Scene::Private {
         auto* object = new Object3D{ parent };
         object->setTransformation(objectData->transformation());
         if (objectData->instanceType() == Trade::ObjectInstanceType3D::Mesh && objectData->instance() != -1 &&
-            meshes[objectData->instance()]) {
-            auto& mesh = meshes[objectData->instance()];
+            loadedMeshes[objectData->instance()]) {
             auto& meshExtent = meshExtents[objectData->instance()];
             extent += meshExtent;
             const Int materialId = static_cast<Trade::MeshObjectData3D*>(objectData.get())->material();
-            if (materialId == -1 || !materials[materialId]) {
-                new ColoredDrawable{ *object, coloredShader, *meshes[objectData->instance()], 0xffffff_rgbf, drawables };
-            } else if (materials[materialId]->flags() & Trade::PhongMaterialData::Flag::DiffuseTexture) {
-                Containers::Optional<GL::Texture2D>& texture = textures[materials[materialId]->diffuseTexture()];
-                if (texture) {
-                    new TexturedDrawable{ *object, texturedShader, *meshes[objectData->instance()], *texture, drawables };
+            addMeshDrawable(*object, (UnsignedInt)objectData->instance(), materialId);
+        }
+
+        for (std::size_t id : objectData->children()) {
+            extent += addObject(importer, object, (Magnum::UnsignedInt)id);
+        }
+        return extent;
+    }
+
+    void addMeshDrawable(Object3D& object, UnsignedInt meshId, Int materialId) {
+        GL::Texture2D* texture = nullptr;
+        Color4 color = 0xffffff_rgbf;
+        if (materialId != -1 && materials[materialId]) {
+            if (materials[materialId]->flags() & Trade::PhongMaterialData::Flag::DiffuseTexture) {
+                auto& diffuseTexture = textures[materials[materialId]->diffuseTexture()];
+                if (diffuseTexture) {
+                    texture = &*diffuseTexture;
+                }
+            } else {
+                color = materials[materialId]->diffuseColor();
+            }
+        }
+
+        if (instancing || stereoInstancing || batch) {
+            pendingInstances.push_back({ &object, meshId, texture, color });
+            return;
+        }
+
+        BoundedDrawable* drawable;
+        if (texture) {
+            drawable = new TexturedDrawable{ object, shaders, *meshes[meshId], *texture, drawables };
+        } else {
+            drawable = new ColoredDrawable{ object, shaders, *meshes[meshId], color, drawables };
+        }
+        drawable->setBounds(getMeshBounds(meshId));
+    }
+
+    Range3D getMeshBounds(UnsignedInt meshId) const {
+        const auto& extent = meshExtents[meshId];
+        return { extent.corner, extent.calcTopFarLeft() };
+    }
+
+    // Groups the pending instances by mesh, which each get one instance buffer, then by texture, which each get one
+    // draw.  The diffuse color is per instance, so nodes with different untextured materials are drawn together.
+    // Stereo instancing without instancing gives every node a draw of its own
+    void buildInstances(Object3D& anchor) {
+        std::stable_sort(pendingInstances.begin(), pendingInstances.end(), [](const auto& a, const auto& b) {
+            return a.mesh != b.mesh ? a.mesh < b.mesh : std::less<GL::Texture2D*>{}(a.texture, b.texture);
+        });
+        auto end = pendingInstances.end();
+        for (auto meshBegin = pendingInstances.begin(); meshBegin != end;) {
+            auto meshId = meshBegin->mesh;
+            auto meshEnd = std::find_if(meshBegin, end, [&](const auto& pending) { return pending.mesh != meshId; });
+            auto& instanceBuffer = *instanceBuffers.emplace_back(std::make_unique<InstanceBuffer>());
+            for (auto groupBegin = meshBegin; groupBegin != meshEnd;) {
+                auto* texture = groupBegin->texture;
+                auto groupEnd = groupBegin + 1;
+                if (instancing) {
+                    groupEnd =
+                        std::find_if(groupBegin, meshEnd, [&](const auto& pending) { return pending.texture != texture; });
+                }
+                auto baseInstance = addInstances(instanceBuffer, groupBegin, groupEnd);
+                auto& shader = getInstancedShader(texture);
+                auto instanceCount = (UnsignedInt)(groupEnd - groupBegin);
+                auto& group = stereoInstancing ? stereoDrawables : drawables;
+                auto* drawable = new InstancedDrawable{
+                    anchor, shader, *meshes[meshId], texture, instanceBuffer, instanceBuffer.groups.size(), group
+                };
+                instanceBuffer.groups.push_back({ baseInstance, instanceCount, getMeshBounds(meshId), {}, drawable });
+                ++stats.instanceGroups;
+                groupBegin = groupEnd;
+            }
+            meshes[meshId]->addVertexBufferInstanced(instanceBuffer.buffer, stereoInstancing ? 2 : 1, 0,
+                                                     InstancedPhongShader::InstanceTransformation{},
+                                                     InstancedPhongShader::InstanceColor{});
+            meshBegin = meshEnd;
+        }
+        stats.instances += (uint32_t)pendingInstances.size();
+        pendingInstances.clear();
+    }
+
+    InstancedPhongShader& getInstancedShader(GL::Texture2D* texture) {
+        if (stereoInstancing) {
+            return texture ? stereoTexturedShader : stereoColoredShader;
+        }
+        return texture ? instancedTexturedShader : instancedColoredShader;
+    }
+
+    // Returns the index of the first of the instances added
+    static UnsignedInt addInstances(InstanceBuffer& instanceBuffer,
+                                    std::vector<PendingInstance>::const_iterator begin,
+                                    std::vector<PendingInstance>::const_iterator end) {
+        auto baseInstance = (UnsignedInt)instanceBuffer.instances.size();
+        for (auto itr = begin; itr != end; ++itr) {
+            new InstanceFeature{ *itr->object, instanceBuffer, instanceBuffer.instances.size() };
+            instanceBuffer.instances.push_back({ Matrix4{}, itr->color });
+            instanceBuffer.objects.push_back(itr->object);
+            // Makes sure the feature is cleaned with the initial transformation
+            itr->object->setDirty();
+        }
+        return baseInstance;
+    }
+
+    // Like `buildInstances()`, but grouping the pending instances by texture first, which each get one multi-draw,
+    // then by mesh, which each get one command of it, all in the static batch
+    void buildBatch() {
+        auto& instanceBuffer = batch->instances;
+        std::stable_sort(pendingInstances.begin(), pendingInstances.end(), [](const auto& a, const auto& b) {
+            return a.texture != b.texture ? std::less<GL::Texture2D*>{}(a.texture, b.texture) : a.mesh < b.mesh;
+        });
+        auto end = pendingInstances.end();
+        for (auto materialBegin = pendingInstances.begin(); materialBegin != end;) {
+            auto* texture = materialBegin->texture;
+            auto materialEnd =
+                std::find_if(materialBegin, end, [&](const auto& pending) { return pending.texture != texture; });
+            auto& shader = getInstancedShader(texture);
+            auto sortKey = SortKey::make(BoundedDrawable::Pass::Opaque, shader.id(), texture ? texture->id() : 0, 0.0f, farZ);
+            auto firstCommand = batch->commands.size();
+            for (auto groupBegin = materialBegin; groupBegin != materialEnd;) {
+                auto meshId = groupBegin->mesh;
+                auto groupEnd = groupBegin + 1;
+                if (instancing) {
+                    groupEnd =
+                        std::find_if(groupBegin, materialEnd, [&](const auto& pending) { return pending.mesh != meshId; });
+                }
+                auto baseInstance = addInstances(instanceBuffer, groupBegin, groupEnd);
+                auto instanceCount = (UnsignedInt)(groupEnd - groupBegin);
+                const auto& range = batch->meshRanges[meshId];
+                batch->commands.push_back(
+                    { range.indexCount, instanceCount, range.firstIndex, range.baseVertex, baseInstance });
+                instanceBuffer.groups.push_back({ baseInstance, instanceCount, getMeshBounds(meshId), {}, nullptr });
+                ++stats.instanceGroups;
+                groupBegin = groupEnd;
+            }
+            batch->materialGroups.push_back(
+                { &shader, texture, firstCommand, batch->commands.size() - firstCommand, sortKey, { false, false } });
+            materialBegin = materialEnd;
+        }
+        batch->upload(stereoInstancing ? 2 : 1);
+        stats.instances += (uint32_t)pendingInstances.size();
+        pendingInstances.clear();
+    }
+
+    void loadSyntheticScene(uint32_t nodeCount) {
+        // Fanning out by 8 at each level gives a hierarchy a few levels deep, like a typical glTF model
+        static const uint32_t FAN_OUT = 8;
+        static const float SPACING = 2.5f;
+        Resource<GL::Mesh> cubeMesh = Shared::get().buildCubePrimitive();
+        boundsHierarchy.clear();
+        modelsRoot->children().clear();
+        instanceBuffers.clear();
+        batch.reset();
+        stats.instances = 0;
+        stats.instanceGroups = 0;
+        std::vector<Object3D*> parents{ new Object3D{ modelsRoot } };
+        auto gridSize = (uint32_t)std::ceil(std::cbrt((float)nodeCount));
+        for (uint32_t i = 0; i < nodeCount; ++i) {
+            auto* object = new Object3D{ parents[i / FAN_OUT] };
+            parents.push_back(object);
+            // Positioned in the root's space, regardless of the depth in the hierarchy
+            Vector3 position{ (float)(i % gridSize), (float)((i / gridSize) % gridSize), (float)(i / (gridSize * gridSize)) };
+            position = (position - Vector3{ (float)gridSize * 0.5f }) * SPACING;
+            object->setTransformation(object->parent()->absoluteTransformationMatrix().inverted() *
+                                      Matrix4::translation(position));
+            Color4 color{ (float)(i % 7) / 6.0f, (float)(i % 5) / 4.0f, (float)(i % 3) / 2.0f };
+            auto* drawable = new ColoredDrawable{ *object, shaders, *cubeMesh, color, drawables };
+            drawable->setBounds(CUBE_BOUNDS);
+        }
+        // Scale the grid down to the same size as a loaded model
+        float modelScale = 0.5f / ((float)gridSize * SPACING);
+        parents.front()->setTransformation(Matrix4::scaling({ modelScale, modelScale, modelScale }));
+    }
+
+    void buildDrawList() {
+        auto start = Clock::now();
+        // The camera matrices are cached on the camera objects, so they're updated here rather than on the workers
+        std::array<Matrix4, 2> cameraMatrices;
+        std::array<Matrix4, 2> eyeTransforms;
+        std::array<xr::Fovf, 2> eyeFovs;
+        std::array<Frustum, 2> eyeFrustums;
+        xr::for_each_side_index([&](uint32_t eyeIndex) {
+            auto& eyeData = eyesData[eyeIndex];
+            cameraMatrices[eyeIndex] = eyeData.camera->cameraMatrix();
+            eyeTransforms[eyeIndex] = cameraMatrices[eyeIndex].invertedRigid();
+            eyeFovs[eyeIndex] = eyeData.fov;
+            eyeFrustums[eyeIndex] = Frustum::fromMatrix(eyeData.camera->projectionMatrix() * cameraMatrices[eyeIndex]);
+        });
+        auto stereoFrustum = Frustum::enclosingStereo(eyeTransforms, eyeFovs, nearZ, farZ);
+        const auto* cullFrustum = culling != Culling::None ? &stereoFrustum : nullptr;
+        const auto* perEyeFrustums = culling == Culling::PerEye ? &eyeFrustums : nullptr;
+        // Sort keys are by depth ahead of the point between the eyes
+        auto viewPosition = (eyeTransforms[0].translation() + eyeTransforms[1].translation()) * 0.5f;
+        auto viewDirection = -(eyeTransforms[0].backward() + eyeTransforms[1].backward()).normalized();
+        auto getDepth = [&](const Vector3& center) { return Math::dot(center - viewPosition, viewDirection); };
+
+        // Ahead of the traversal, which leaves the instanced drawables out of the eyes none of their instances are left
+        // for.  Stereo instances are drawn once for both eyes, so they're only culled against the stereo frustum
+        stats.culledInstances = 0;
+        for (auto& instanceBuffer : instanceBuffers) {
+            instanceBuffer->update();
+            stats.culledInstances +=
+                (uint32_t)instanceBuffer->cull(cullFrustum, stereoInstancing ? nullptr : perEyeFrustums);
+            instanceBuffer->compact();
+        }
+        if (batch) {
+            batch->instances.update();
+            stats.culledInstances +=
+                (uint32_t)batch->instances.cull(cullFrustum, stereoInstancing ? nullptr : perEyeFrustums);
+            batch->instances.compact();
+            batch->updateCommands(stereoInstancing);
+        }
+
+        const auto drawableCount = drawables.size();
+        if (boundsHierarchy.stale || boundsHierarchy.drawableNodes.size() != drawableCount) {
+            boundsHierarchy.build(drawables);
+        }
+        worldTransforms.resize(drawableCount);
+        worldBounds.resize(drawableCount);
+        eyeMasks.resize(drawableCount);
+        boundsHierarchy.update(drawables, worldBounds);
+        stats.culledSubtrees = cullHierarchy(cullFrustum, perEyeFrustums);
+        threadPackets.resize(traversal.getThreadCount());
+        // Cleared here rather than by the tasks, as a thread given no batches doesn't run the task at all
+        for (auto& packets : threadPackets) {
+            packets.clear();
+        }
+        // Split in whole culling batches, so that no batch straddles two threads
+        const auto batchCount = (drawableCount + BoxCuller::BATCH - 1) / BoxCuller::BATCH;
+        traversal.run(batchCount, [&](uint32_t thread, size_t batchBegin, size_t batchEnd) {
+            auto begin = batchBegin * BoxCuller::BATCH;
+            auto end = std::min(batchEnd * BoxCuller::BATCH, drawableCount);
+            for (size_t i = begin; i < end; ++i) {
+                // Starting from the eyes the drawable's node isn't culled from, which are none in a culled subtree
+                auto node = boundsHierarchy.drawableNodes[i];
+                worldTransforms[i] = boundsHierarchy.nodes[node].world;
+                eyeMasks[i] = nodeMasks[node];
+            }
+            if (culling != Culling::None) {
+                worldBounds.cull(stereoFrustum, begin, end, BOTH_EYES, eyeMasks.data());
+            }
+            if (culling == Culling::PerEye) {
+                worldBounds.cull(eyeFrustums[0], begin, end, LEFT_EYE, eyeMasks.data());
+                worldBounds.cull(eyeFrustums[1], begin, end, RIGHT_EYE, eyeMasks.data());
+            }
+
+            auto& packets = threadPackets[thread];
+            for (size_t i = begin; i < end; ++i) {
+                auto& drawable = static_cast<BoundedDrawable&>(drawables[i]);
+                xr::for_each_side_index([&](uint32_t eyeIndex) {
+                    if (drawable.isEmpty(eyeIndex)) {
+                        eyeMasks[i] &= (uint8_t)~(1 << eyeIndex);
+                    }
+                });
+                if (eyeMasks[i] == 0) {
+                    continue;
+                }
+                DrawPacket packet;
+                packet.sortKey = SortKey::make(drawable, getDepth(worldBounds.getCenter(i)), farZ);
+                packet.index = (uint32_t)i;
+                packet.drawable = &drawable;
+                packet.eyes = eyeMasks[i];
+                xr::for_each_side_index([&](uint32_t eyeIndex) {
+                    packet.transformations[eyeIndex] = cameraMatrices[eyeIndex] * worldTransforms[i];
+                });
+                packets.push_back(packet);
+            }
+        });
+
+        drawList.clear();
+        for (const auto& packets : threadPackets) {
+            drawList.insert(drawList.end(), packets.begin(), packets.end());
+        }
+        sortDrawList(drawList);
+        stats.culledForOneEye = 0;
+        xr::for_each_side_index([&](uint32_t eyeIndex) {
+            auto& eyeDrawList = eyeDrawLists[eyeIndex];
+            eyeDrawList.clear();
+            for (const auto& packet : drawList) {
+                if (0 != (packet.eyes & (1 << eyeIndex))) {
+                    eyeDrawList.emplace_back(*packet.drawable, packet.transformations[eyeIndex]);
                 } else {
-                    new ColoredDrawable{ *object, coloredShader, *meshes[objectData->instance()], 0xffffff_rgbf, drawables };
+                    ++stats.culledForOneEye;
                 }
+            }
+        });
+
+        // Culled with their instances above
+        stereoDrawList.clear();
+        for (size_t i = 0; i < stereoDrawables.size(); ++i) {
+            auto& drawable = static_cast<BoundedDrawable&>(stereoDrawables[i]);
+            if (!drawable.isEmpty(0)) {
+                DrawPacket packet;
+                packet.sortKey = SortKey::make(drawable, getDepth(drawable.getBounds().center()), farZ);
+                packet.index = (uint32_t)i;
+                packet.drawable = &drawable;
+                stereoDrawList.push_back(packet);
+            }
+        }
+        sortDrawList(stereoDrawList);
+
+        size_t batchCommands = 0;
+        size_t batchDrawn = 0;
+        if (batch) {
+            batchCommands = batch->commands.size();
+            for (const auto& group : batch->instances.groups) {
+                auto eyes = (group.frameCount[0] != 0 ? 1 : 0) + (group.frameCount[1] != 0 ? 1 : 0);
+                if (eyes != 0) {
+                    ++batchDrawn;
+                }
+                if (eyes == 1) {
+                    ++stats.culledForOneEye;
+                }
+            }
+        }
+        countStateChanges();
+
+        stats.threads = traversal.getThreadCount();
+        stats.drawables = (uint32_t)(drawableCount + stereoDrawables.size() + batchCommands);
+        stats.drawn = (uint32_t)(drawList.size() + stereoDrawList.size() + batchDrawn);
+        stats.culled = stats.drawables - stats.drawn;
+        stats.traversalTime = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+    }
+
+    // Tests each node of the hierarchy only for the eyes its parent isn't culled from, skipping the subtrees of the
+    // nodes culled from both.  Returns the subtrees skipped
+    uint32_t cullHierarchy(const Frustum* stereoFrustum, const std::array<Frustum, 2>* eyeFrustums) {
+        const auto& nodes = boundsHierarchy.nodes;
+        const auto& bounds = boundsHierarchy.bounds;
+        nodeMasks.assign(nodes.size(), 0);
+        uint32_t culledSubtrees = 0;
+        for (size_t n = 0; n < nodes.size();) {
+            const auto& node = nodes[n];
+            auto mask = node.parent == -1 ? BOTH_EYES : nodeMasks[node.parent];
+            if (stereoFrustum && bounds.isOutside(*stereoFrustum, n)) {
+                mask = 0;
+            }
+            if (eyeFrustums) {
+                xr::for_each_side_index([&](uint32_t eyeIndex) {
+                    if (0 != (mask & (1 << eyeIndex)) && bounds.isOutside((*eyeFrustums)[eyeIndex], n)) {
+                        mask &= (uint8_t)~(1 << eyeIndex);
+                    }
+                });
+            }
+            nodeMasks[n] = mask;
+            if (mask == 0) {
+                ++culledSubtrees;
+                n = node.subtreeEnd;
             } else {
-                new ColoredDrawable{ *object, coloredShader, *meshes[objectData->instance()],
-                                     materials[materialId]->diffuseColor(), drawables };
+                ++n;
             }
         }
+        return culledSubtrees;
+    }
 
-        for (std::size_t id : objectData->children()) {
-            extent += addObject(importer, object, (Magnum::UnsignedInt)id);
+    // By sort key or, without sorting, in the order of the drawable group, so that either way the draw order doesn't
+    // depend on how the traversal was split across threads
+    void sortDrawList(std::vector<DrawPacket>& packets) const {
+        if (drawSorting) {
+            std::sort(packets.begin(), packets.end(), [](const DrawPacket& a, const DrawPacket& b) {
+                return a.sortKey != b.sortKey ? a.sortKey < b.sortKey : a.index < b.index;
+            });
+        } else {
+            std::sort(packets.begin(), packets.end(),
+                      [](const DrawPacket& a, const DrawPacket& b) { return a.index < b.index; });
         }
-        return extent;
+    }
+
+    // The shader and texture binds of the draws, in the order `render()` submits them.  The bound state carries over
+    // from one draw to the next, and a texture stays bound through the draws that don't use one
+    void countStateChanges() {
+        UnsignedInt shader = 0;
+        UnsignedInt material = 0;
+        stats.shaderChanges = 0;
+        stats.materialChanges = 0;
+        auto submit = [&](uint64_t sortKey) {
+            auto packetShader = SortKey::getShader(sortKey);
+            auto packetMaterial = SortKey::getMaterial(sortKey);
+            if (packetShader != shader) {
+                shader = packetShader;
+                ++stats.shaderChanges;
+            }
+            if (packetMaterial != 0 && packetMaterial != material) {
+                material = packetMaterial;
+                ++stats.materialChanges;
+            }
+        };
+        auto submitBatch = [&](size_t set) {
+            for (const auto& group : batch->materialGroups) {
+                if (group.visible[set]) {
+                    submit(group.sortKey);
+                }
+            }
+        };
+        for (const auto& packet : stereoDrawList) {
+            submit(packet.sortKey);
+        }
+        if (batch && stereoInstancing) {
+            submitBatch(0);
+        }
+        xr::for_each_side_index([&](uint32_t eyeIndex) {
+            if (batch && !stereoInstancing) {
+                submitBatch(eyeIndex);
+            }
+            for (const auto& packet : drawList) {
+                if (0 != (packet.eyes & (1 << eyeIndex))) {
+                    submit(packet.sortKey);
+                }
+            }
+        });
+    }
+
+    // The smallest viewport that covers both eyes' viewports
+    static xr::Rect2Di getStereoViewport(const Framebuffer& framebuffer) {
+        auto left = framebuffer.getViewportSide(0);
+        auto right = framebuffer.getViewportSide(1);
+        return { left.offset, { right.offset.x + right.extent.width - left.offset.x, left.extent.height } };
+    }
+
+    // Everything the shaders need that's the same for every draw of a frame, uploaded once, rather than set again
+    // with every draw
+    void updateFrameUniforms(const Framebuffer& framebuffer) {
+        FrameUniforms frameUniforms;
+        frameUniforms.lightPosition = Vector4{ LIGHT_POSITION, 1.0f };
+        auto stereoViewport = getStereoViewport(framebuffer);
+        xr::for_each_side_index([&](uint32_t eyeIndex) {
+            auto& camera = *eyesData[eyeIndex].camera;
+            auto& uniforms = frameUniforms.eyes[eyeIndex];
+            uniforms.viewMatrix = camera.cameraMatrix();
+            uniforms.projectionMatrix = camera.projectionMatrix();
+            uniforms.cameraPosition = Vector4{ uniforms.viewMatrix.invertedRigid().translation(), 1.0f };
+            uniforms.viewLightPosition = Vector4{ uniforms.viewMatrix.transformPoint(LIGHT_POSITION), 1.0f };
+            if (stereoInstancing) {
+                // Squeezes the eye's clip space horizontally into its part of the stereo viewport, and clips to it
+                auto eyeViewport = framebuffer.getViewportSide(eyeIndex);
+                auto viewportWidth = (float)stereoViewport.extent.width;
+                auto eyeLeft = (float)(eyeViewport.offset.x - stereoViewport.offset.x);
+                auto scale = (float)eyeViewport.extent.width / viewportWidth;
+                // Where the center of the eye's viewport lands in the stereo viewport's normalized device coordinates
+                auto offset = (2.0f * eyeLeft + (float)eyeViewport.extent.width) / viewportWidth - 1.0f;
+                uniforms.stereoProjectionMatrix = Matrix4::translation({ offset, 0.0f, 0.0f }) *
+                                                  Matrix4::scaling({ scale, 1.0f, 1.0f }) * uniforms.projectionMatrix;
+                uniforms.clipPlanes[0] = { 1.0f, 0.0f, 0.0f, scale - offset };
+                uniforms.clipPlanes[1] = { -1.0f, 0.0f, 0.0f, scale + offset };
+            }
+        });
+        frameUniformBuffer.setData({ &frameUniforms, sizeof(frameUniforms) }, GL::BufferUsage::DynamicDraw);
+        frameUniformBuffer.bind(GL::Buffer::Target::Uniform, FRAME_UNIFORMS_BINDING);
+        shaders.uniformBytes += sizeof(frameUniforms);
+    }
+
+    // Magnum's vertex array, program and texture bindings are left as they were, as far as its state tracking knows
+    uint32_t drawBatch(size_t set) {
+        GL::Context::current().resetState(GL::Context::State::EnterExternal);
+        auto draws = batch->draw(set);
+        GL::Context::current().resetState(GL::Context::State::ExitExternal);
+        return draws;
     }
 
     void render(Framebuffer& framebuffer) {
+        buildDrawList();
+        auto start = Clock::now();
+        shaders.uniformBytes = 0;
+        stats.multiDraws = 0;
+        updateFrameUniforms(framebuffer);
+        if (stereoInstancing) {
+            framebuffer.setViewport(getStereoViewport(framebuffer));
+            GL::Renderer::enable(GL::Renderer::Feature::ClipDistance0);
+            GL::Renderer::enable(GL::Renderer::Feature::ClipDistance1);
+            for (const auto& packet : stereoDrawList) {
+                static_cast<InstancedDrawable*>(packet.drawable)->draw();
+            }
+            if (batch) {
+                stats.multiDraws += drawBatch(0);
+            }
+            GL::Renderer::disable(GL::Renderer::Feature::ClipDistance0);
+            GL::Renderer::disable(GL::Renderer::Feature::ClipDistance1);
+        }
         xr::for_each_side_index([&](uint32_t eyeIndex) {
             framebuffer.setViewportSide(eyeIndex);
+            instancedColoredShader.setEyeIndex(eyeIndex);
+            instancedTexturedShader.setEyeIndex(eyeIndex);
+            shaders.uniformColored.setEyeIndex(eyeIndex);
+            shaders.uniformTextured.setEyeIndex(eyeIndex);
+            shaders.uniformBytes += 4 * sizeof(Int);
+            if (batch && !stereoInstancing) {
+                stats.multiDraws += drawBatch(eyeIndex);
+            }
             auto& camera = *eyesData[eyeIndex].camera;
-            camera.setViewport(fromXr(framebuffer.getEyeSize()));
-            camera.draw(drawables);
+            camera.setViewport(fromXr(framebuffer.getViewportSide(eyeIndex).extent));
+            camera.draw(eyeDrawLists[eyeIndex]);
         });
+        // Every drawable issues exactly one draw, for one eye or, stereo instanced, both
+        stats.drawCalls =
+            (uint32_t)(eyeDrawLists[0].size() + eyeDrawLists[1].size() + stereoDrawList.size()) + stats.multiDraws;
+        stats.uniformBytes = shaders.uniformBytes;
+        stats.submitTime = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
     }
 };
 
@@ -670,11 +2120,50 @@ void Scene::updateHands(const xr_examples::HandStates& handStates) {
     });
 }
 
+void Scene::setInstancing(bool instancing) {
+    d->instancing = instancing;
+}
+
+void Scene::setStereoInstancing(bool stereoInstancing) {
+    d->stereoInstancing = stereoInstancing;
+}
+
+void Scene::setCulling(Culling culling) {
+    d->culling = culling;
+}
+
+void Scene::setUniformBuffer(bool uniformBuffer) {
+    d->shaders.uniformBuffer = uniformBuffer;
+}
+
+void Scene::setBatching(bool batching) {
+    d->batching = batching;
+}
+
+void Scene::setDrawSorting(bool drawSorting) {
+    d->drawSorting = drawSorting;
+}
+
+void Scene::setThreadCount(uint32_t threadCount) {
+    d->traversal.setThreadCount(threadCount);
+}
+
+void Scene::loadSyntheticScene(uint32_t nodeCount) {
+    d->loadSyntheticScene(nodeCount);
+}
+
+const Scene::Stats& Scene::getStats() const {
+    return d->stats;
+}
+
 void Scene::updateEyes(const xr_examples::EyeStates& eyeStates) {
     xr::for_each_side_index([&](uint32_t eyeIndex) {
         const auto& eyeState = eyeStates[eyeIndex];
         auto& eyeData = d->eyesData[eyeIndex];
-        eyeData.camera->setProjectionMatrix(fromXrGL(eyeState.fov));
+        eyeData.camera->setProjectionMatrix(fromXrGL(eyeState.fov, nearZ, farZ));
         eyeData.cameraObject->setTransformation(fromXr(eyeState.pose));
+        eyeData.fov = eyeState.fov;
     });
+    d->nearZ = nearZ;
+    d->farZ = farZ;
 }
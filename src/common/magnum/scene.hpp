@@ -9,6 +9,46 @@ class Scene : public xr_examples::Scene {
     struct Private;
 
 public:
+    enum class Culling
+    {
+        None,
+        // Against a single frustum enclosing both eyes' frustums
+        Stereo,
+        // Also against each eye's own frustum, so that drawables only one eye sees aren't drawn for the other
+        PerEye,
+    };
+
+    // Counters and CPU times of the last `render()`, times in milliseconds
+    struct Stats {
+        uint32_t threads{ 1 };
+        uint32_t drawables{ 0 };
+        // Drawables drawn for at least one eye, and those outside the stereo frustum, which aren't drawn at all
+        uint32_t drawn{ 0 };
+        uint32_t culled{ 0 };
+        // Draws skipped for one eye of drawables the other eye sees, with `Culling::PerEye`
+        uint32_t culledForOneEye{ 0 };
+        // Subtrees of the scene culled by their bounds alone, without testing any of the drawables in them
+        uint32_t culledSubtrees{ 0 };
+        // Instances culled for both eyes, which are left out of their instanced draw or multi-draw command
+        uint32_t culledInstances{ 0 };
+        // Building the draw list: world transforms, culling and sort keys of every drawable, on `threads` threads
+        float traversalTime{ 0.0f };
+        // Replaying the draw list for both eyes on the GL thread
+        float submitTime{ 0.0f };
+        uint32_t drawCalls{ 0 };
+        // Of the draw calls, the multi-draws of a statically batched model, each drawing many meshes
+        uint32_t multiDraws{ 0 };
+        // Shader program and texture binds between the draws, as submitted
+        uint32_t shaderChanges{ 0 };
+        uint32_t materialChanges{ 0 };
+        // Mesh nodes of the loaded model that are drawn instanced, and the draws they're grouped into, per eye or for
+        // both eyes with stereo instancing
+        uint32_t instances{ 0 };
+        uint32_t instanceGroups{ 0 };
+        // Bytes of uniforms set or uploaded for the frame, per draw and in the frame's uniform buffer
+        size_t uniformBytes{ 0 };
+    };
+
     virtual ~Scene();
     void render(xr_examples::Framebuffer& stereoFramebuffer) override;
     void create() override;
@@ -17,6 +57,33 @@ public:
     void destroy() override;
     void updateHands(const HandStates& handStates) override;
     void updateEyes(const EyeStates& eyeStates) override;
+    // Draw every node of a loaded model that shares its mesh and texture with others in one instanced draw.  Must
+    // be set before `loadModel()`, defaults to true
+    void setInstancing(bool instancing);
+    // Draw the nodes of a loaded model once for both eyes of a double wide framebuffer, rather than once per eye, by
+    // drawing each instance twice and routing the second to the right eye with clip distances.  Needs nothing beyond
+    // GL 4.5, unlike multiview.  Must be set before `loadModel()`, defaults to false
+    void setStereoInstancing(bool stereoInstancing);
+    // How drawables are culled against the eyes' frustums, using the bounds of their meshes, joined up the scene's
+    // hierarchy so that a subtree outside the frustums is culled as a whole.  Instanced draws and batched commands are
+    // culled instance by instance.  Defaults to `Culling::Stereo`
+    void setCulling(Culling culling);
+    // Read the eyes' projections and the light from a uniform buffer written once a frame, so that each draw only
+    // sets its transformation and color, rather than setting all of them with every draw through Magnum's Phong
+    // shader.  Defaults to true
+    void setUniformBuffer(bool uniformBuffer);
+    // Pack the meshes of a loaded model into one vertex and one index buffer, and draw all its nodes with the same
+    // texture with one multi-draw-indirect, in place of the instanced draws.  Must be set before `loadModel()`,
+    // defaults to true
+    void setBatching(bool batching);
+    // Submit the draws sorted by shader and texture, then front to back, with the skybox last, rather than in the order
+    // the drawables were added.  Defaults to true
+    void setDrawSorting(bool drawSorting);
+    // How many threads, the calling one included, the scene graph traversal is split across.  Defaults to one
+    void setThreadCount(uint32_t threadCount);
+    // Replaces the model with `nodeCount` cubes in a hierarchy a few levels deep, for benchmarking the traversal
+    void loadSyntheticScene(uint32_t nodeCount);
+    const Stats& getStats() const;
 
 private:
     std::shared_ptr<Private> d;
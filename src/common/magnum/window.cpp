@@ -27,6 +27,9 @@ struct OffscreenContext : public xr_examples::Context {
 
     void makeCurrent() const override { SDL_GL_MakeCurrent(window, glContext); }
     void doneCurrent() const override { SDL_GL_MakeCurrent(window, nullptr); }
+    // The context is made current on the window itself, not a hidden surface
+    bool canPresent() const override { return true; }
+    void present() const override { SDL_GL_SwapWindow(window); }
     void destroy() {
         SDL_GL_DeleteContext(glContext);
         glContext = nullptr;
@@ -58,13 +61,19 @@ struct xr_examples::magnum::Window::Private : public Magnum::Platform::Applicati
 
     void viewportEvent(ViewportEvent& event) override { size = event.windowSize(); }
 
-    void drawEvent() override { handler(); }
+    // The loop always requests another frame, `setMinimalLoopPeriod` is what throttles it while idle
+    void drawEvent() override {
+        handler();
+        redraw();
+    }
 
     void makeCurrent() { SDL_GL_MakeCurrent(window(), glContext); }
 
     void doneCurrent() { SDL_GL_MakeCurrent(window(), nullptr); }
 
     Context::Pointer createOffscreenContext() { return std::make_shared<OffscreenContext>(window()); }
+
+    void setLoopInterval(uint32_t milliseconds) { setMinimalLoopPeriod(milliseconds); }
 };
 
 void Window::init() {
@@ -100,13 +109,16 @@ void Window::requestClose() {
 
 void Window::swapBuffers() const {
     d->swapBuffers();
-    d->redraw();
 }
 
 void Window::setTitle(const std::string& title) const {
     SDL_SetWindowTitle(d->window(), title.c_str());
 }
 
+void Window::setLoopInterval(uint32_t milliseconds) {
+    d->setLoopInterval(milliseconds);
+}
+
 void Window::runWindowLoop(const std::function<void()>& handler) {
     d->handler = handler;
     d->redraw();
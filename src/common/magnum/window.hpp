@@ -18,6 +18,7 @@ public:
     void doneCurrent() const override;
     void setSwapInterval(uint32_t swapInterval) const override;
     void setTitle(const ::std::string& title) const override;
+    void setLoopInterval(uint32_t milliseconds) override;
     void runWindowLoop(const ::std::function<void()>& handler) override;
     void swapBuffers() const override;
     void requestClose() override;
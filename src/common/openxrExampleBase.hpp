@@ -32,11 +32,25 @@
 #include <vks/context.hpp>
 #endif
 
+#if defined(XR_USE_GRAPHICS_API_OPENGL) && defined(XR_USE_PLATFORM_XLIB)
+#include <glad/glad.h>
+#include <GL/glx.h>
+#endif
+
 #include <xrs/context.hpp>
 #include <xrs/swapchain.hpp>
 #include <gl/framebuffer.hpp>
 #include <gl/debug.hpp>
+#include <gl/eyeViews.hpp>
+#include <gl/mirror.hpp>
+#include <gl/profiler.hpp>
+#include <gl/renderWorkerPool.hpp>
 #include <interfaces.hpp>
+#include <frameTimings.hpp>
+#include <frameInput.hpp>
+#include <idleScheduler.hpp>
+#include <resolutionScaler.hpp>
+#include <foveation.hpp>
 #include <assets.hpp>
 #include <glad.hpp>
 
@@ -54,12 +68,79 @@ public:
     EyeStates eyeStates;
     float fpsTimer{ 0.0f };
     float lastFps{ 0.0f };
+    // The clip planes of every eye projection the scene layer is rendered with, and that are submitted with its depth.
+    // Set them before `prepare()`
     float nearZ{ 0.01f };
     float farZ{ 1000.0f };
+    // Overlap xrWaitFrame for the next frame with the rendering of the current one, see `xrs::Context::pipelined`
+    bool pipelinedFrameLoop{ false };
+    // Locate the eye poses a second time, as late as the scene allows, instead of only at the start of `update()`, so
+    // the rendered poses are as fresh as possible.  Scenes that read `EyeViews` have them latched after their draws are
+    // issued, others get them just before.  See `renderSceneLayer()`
+    bool lateLatchEyePoses{ false };
+    // Per-phase timings for the most recent frames.  If `frameTimingsPath` is set the timings are written
+    // there on exit, as JSON if the path ends in `.json` and CSV otherwise.
+    FrameTimings frameTimings;
+    std::string frameTimingsPath;
+    // Throttles the window loop and the desktop mirror while the session isn't running frames
+    IdleScheduler idleScheduler;
+    // Shrink or grow the rendered eye viewports based on the measured GPU time of the scene layer.  The framebuffers
+    // and swapchains stay at the recommended size, which is the maximum, and the scale limits and hysteresis are
+    // configured on `resolutionScaler`
+    bool adaptiveResolution{ false };
+    ResolutionScaler resolutionScaler;
+    // Render the scene layer straight into the acquired swapchain image, instead of rendering to the framebuffer's own
+    // color texture and blitting that to the swapchain.  A GL `framebuffer` is replaced by `projectionFramebuffer`,
+    // which already has an FBO for every swapchain image, and other framebuffers have the image attached as their
+    // color buffer.  The desktop mirror then reads from the swapchain image, before it's released.  See
+    // `getSceneFramebuffer()` and `renderSceneLayer()`
+    bool renderDirectToSwapchain{ false };
+    // Render both eyes with a single set of draws, into a texture array with one layer per eye via GL_OVR_multiview,
+    // and submit them from an array swapchain.  Falls back to the double wide framebuffer and swapchain if the
+    // scene, the GL driver or the OpenXR runtime doesn't support it.  See `isMultiview()`
+    bool multiviewRendering{ false };
+    // Submit the depth of the scene layer alongside its color with XR_KHR_composition_layer_depth, so the runtime can
+    // reproject positionally rather than only rotationally when a frame is late.  The scene is rendered straight into
+    // the depth swapchain images, in the most preferred format of `xrs::DEPTH_SWAPCHAIN_FORMATS` that the runtime
+    // supports, and depth isn't submitted if it supports none of them.  See `isSubmittingDepth()`
+    bool submitDepth{ false };
+    // Render each eye's periphery at reduced resolution and only an inset around the optical axis at full resolution,
+    // configured by `foveation`.  The periphery is rendered to `framebuffer` at a reduced viewport scale, the inset to
+    // `insetFramebuffer`, and both are composited into the swapchain image.  This needs the double wide framebuffer
+    // blitted to the swapchain, so it's not used with multiview, direct rendering or depth submission, or for scenes
+    // that can't render the inset, and it replaces `adaptiveResolution`.  The desktop mirror only shows the periphery.
+    // See `isFoveated()`
+    bool foveatedRendering{ false };
+    Foveation foveation;
+    // What the desktop window mirrors of the scene layer, and how often.  The mirror is for whoever is watching the
+    // operator's console, and doesn't need the display rate of the HMD, so only every `mirrorInterval`th frame is
+    // mirrored.  With `asyncMirror` the window is presented from a thread of its own, where the backend supports it,
+    // so a blocking swap can never delay the XR frame.  See `gl::Mirror`
+    gl::Mirror::Mode mirrorMode{ gl::Mirror::Mode::BothEyes };
+    uint32_t mirrorInterval{ 1 };
+    bool asyncMirror{ false };
+    // How many render threads offscreen layers, like UI panels, share between them, each with a GL context of its own,
+    // however many layers there are.  See `gl::RenderWorkerPool`
+    uint32_t renderWorkerCount{ 1 };
+    // Record the per-frame XR input to `recordInputPath`, or replay it from `replayInputPath`, see `FrameInput`.
+    // When replaying no XR instance or session is created at all.  The recorded eye and hand states drive the scene
+    // and frames are rendered to the window as fast as possible, so this only suits examples that render nothing but
+    // the scene layer.
+    std::string recordInputPath;
+    std::string replayInputPath;
 
     OpenXrExampleBase() {
         // Static initialization for whatever our backed (Qt, Magnum, etc) needs
         WindowType::init();
+        if (auto timingsPath = getenv("XR_EXAMPLES_FRAME_TIMINGS")) {
+            frameTimingsPath = timingsPath;
+        }
+        if (auto recordPath = getenv("XR_EXAMPLES_RECORD_INPUT")) {
+            recordInputPath = recordPath;
+        }
+        if (auto replayPath = getenv("XR_EXAMPLES_REPLAY_INPUT")) {
+            replayInputPath = replayPath;
+        }
     }
 
     virtual ~OpenXrExampleBase() {
@@ -73,6 +154,10 @@ public:
     }
 
     virtual void prepare() {
+        if (!replayInputPath.empty()) {
+            prepareReplay();
+            return;
+        }
         prepareXrInstance();
         prepareWindow();
         prepareXrSession();
@@ -80,11 +165,32 @@ public:
         prepareXrActions();
         preapreXrLayers();
         prepareScene();
+        scene.setClipPlanes(nearZ, farZ);
+        if (!recordInputPath.empty()) {
+            inputRecorder.open(recordInputPath, renderTargetSize);
+        }
+    }
+
+    FrameInputRecorder inputRecorder;
+    FrameInputPlayer inputPlayer;
+    size_t replayFrame{ 0 };
+    bool isReplaying() const { return inputPlayer.isOpen(); }
+
+    void prepareReplay() {
+        if (!inputPlayer.open(replayInputPath)) {
+            throw std::runtime_error("Unable to open input recording " + replayInputPath);
+        }
+        renderTargetSize = inputPlayer.getRenderTargetSize();
+        prepareWindow();
+        prepareScene();
+        scene.setClipPlanes(nearZ, farZ);
     }
 
     xrs::Context xrContext;
     void prepareXrInstance() {
-        xrContext.requiredExtensions.insert(XR_KHR_COMPOSITION_LAYER_DEPTH_EXTENSION_NAME);
+        if (submitDepth) {
+            xrContext.requiredExtensions.insert(XR_KHR_COMPOSITION_LAYER_DEPTH_EXTENSION_NAME);
+        }
         // Startup the OpenXR instance and get a system ID and view configuration
         // All of this is independent of the interaction between Xr and the
         // eventual Graphics API used for rendering
@@ -92,10 +198,11 @@ public:
 
         const auto& viewConfigViews = xrContext.viewConfigViews;
 
-        // Instead of createing a swapchain per-eye, we create a single swapchain of double width.
-        // Even preferable would be to create a swapchain texture array with one layer per eye, so that we could use the
-        // VK_KHR_multiview to render both eyes with a single set of draws, but sadly the Oculus runtime doesn't currently
-        // support texture array swapchains
+        // By default we create a single swapchain of double width instead of a swapchain per-eye.  With
+        // `multiviewRendering` we try a texture array swapchain with one layer per eye instead, so that both eyes are
+        // rendered with a single set of draws, but not every runtime supports texture array swapchains (the Oculus
+        // runtime doesn't, currently), so the double wide swapchain remains the fallback.  Either way
+        // `renderTargetSize` is the double wide size
         if (viewConfigViews.size() != 2) {
             throw std::runtime_error("Unexpected number of view configurations");
         }
@@ -109,6 +216,8 @@ public:
     }
 
     WindowType window;
+    // Declared after the window, so the workers are joined and their contexts destroyed before the window is
+    gl::RenderWorkerPool renderWorkers;
     FramebufferType framebuffer;
     void prepareWindow() {
         assert(renderTargetSize.width != 0 && renderTargetSize.height != 0);
@@ -121,7 +230,69 @@ public:
         gl::enableDebugLogging();
 #endif
 
+        // Rendering direct to the swapchain never renders into the framebuffer's own color buffer
+        framebuffer.setExternalColor(isRenderingDirectToSwapchain());
         framebuffer.create(renderTargetSize);
+        if (scene.readsEyeViews()) {
+            eyeViewsUniforms.create();
+        }
+        mirror.create(window, asyncMirror);
+        renderWorkers.create(window, renderWorkerCount);
+        resolutionScaler.reset();
+
+        if (multiviewRendering) {
+            if (!scene.supportsMultiview()) {
+                logging::log(logging::Level::Warning, "Scene can't render multiview, falling back to double wide rendering");
+            } else if (!gl::MultiviewFramebuffer::isSupported()) {
+                logging::log(logging::Level::Warning,
+                             "GL_OVR_multiview isn't supported, falling back to double wide rendering");
+            } else {
+                multiviewFramebuffer.create({ renderTargetSize.width / 2, renderTargetSize.height });
+                multiview = true;
+            }
+        }
+
+        if (foveatedRendering) {
+            if (!scene.supportsFoveation()) {
+                logging::log(logging::Level::Warning, "Scene can't render a foveated inset, not foveating");
+            } else if (multiview || renderDirectToSwapchain || submitDepth) {
+                logging::log(logging::Level::Warning,
+                             "Foveated rendering isn't supported with multiview, direct rendering or depth submission");
+            } else {
+                auto insetSize = foveation.getInsetSize(framebuffer.getEyeSize());
+                insetFramebuffer.create({ insetSize.width * 2, insetSize.height });
+                framebuffer.setViewportScale(foveation.peripheryScale);
+                foveated = true;
+                if (adaptiveResolution) {
+                    logging::log(logging::Level::Warning, "Adaptive resolution is replaced by foveated rendering");
+                    adaptiveResolution = false;
+                }
+            }
+        }
+    }
+
+    // Set by `prepareWindow()` if `foveatedRendering` is requested and possible
+    bool foveated{ false };
+    FramebufferType insetFramebuffer;
+    // Where each eye's inset goes within the eye's half of the swapchain image, updated every frame
+    std::array<xr::Rect2Di, 2> insetRects;
+    bool isFoveated() const { return foveated; }
+
+    // Set by `prepareWindow()` and `preapreXrLayers()` if `multiviewRendering` is requested and supported
+    bool multiview{ false };
+    gl::MultiviewFramebuffer multiviewFramebuffer;
+    bool isMultiview() const { return multiview; }
+    // The framebuffer the scene layer is rendered to
+    Framebuffer& getSceneFramebuffer() {
+        if (multiview) {
+            return multiviewFramebuffer;
+        }
+        if constexpr (std::is_base_of_v<gl::FramebufferBase, FramebufferType>) {
+            if (isRenderingDirectToSwapchain()) {
+                return projectionFramebuffer;
+            }
+        }
+        return framebuffer;
     }
 
     SceneType scene;
@@ -134,6 +305,7 @@ public:
     xr::Session& xrSession{ xrContext.session };
     xr::Extent2Df bounds;
     void prepareXrSession() {
+        xrContext.pipelined = pipelinedFrameLoop;
 #if defined(XR_USE_GRAPHICS_API_VULKAN)
         auto requirements = xrContext.instance.getVulkanGraphicsRequirementsKHR(xrContext.systemId, xrContext.dispatch);
 
@@ -174,7 +346,15 @@ public:
 
 #if defined(XR_USE_GRAPHICS_API_OPENGL) || defined(XR_USE_GRAPHICS_API_OPENGL_ES)
         auto requirements = xrContext.instance.getOpenGLGraphicsRequirementsKHR(xrContext.systemId, xrContext.dispatch);
+#if defined(XR_USE_PLATFORM_WIN32)
         xrContext.createSession(xr::GraphicsBindingOpenGLWin32KHR{ wglGetCurrentDC(), wglGetCurrentContext() });
+#elif defined(XR_USE_PLATFORM_XLIB)
+        xr::GraphicsBindingOpenGLXlibKHR binding;
+        binding.xDisplay = glXGetCurrentDisplay();
+        binding.glxDrawable = glXGetCurrentDrawable();
+        binding.glxContext = glXGetCurrentContext();
+        xrContext.createSession(binding);
+#endif
 #endif
         xrSession.getReferenceSpaceBoundsRect(xr::ReferenceSpaceType::Local, bounds);
     }
@@ -186,21 +366,20 @@ public:
 
     std::vector<xr::CompositionLayerBaseHeader*> layersPointers;
 
-#define USE_DEPTH_INFO 0
     std::array<xr::CompositionLayerProjectionView, 2> projectionLayerViews;
     xr::CompositionLayerProjection projectionLayer{ {}, {}, 2, projectionLayerViews.data() };
     xr::Swapchain projectionColorSwapchain;
 
-#if USE_DEPTH_INFO
-    std::array<xr::CompositionLayerDepthInfoKHR, 2> projectionDeptInfos;
+    std::array<xr::CompositionLayerDepthInfoKHR, 2> projectionDepthInfos;
     xr::Swapchain projectionDepthSwapchain;
-#endif
+    bool projectionDepthHasStencil{ true };
+    bool isSubmittingDepth() const { return (bool)projectionDepthSwapchain; }
 
     gl::SwapchainFramebuffer projectionFramebuffer;
 
     void preapreXrLayers() {
         xr::SwapchainCreateInfo ci;
-        ci.usageFlags = xr::SwapchainUsageFlagBits::TransferDst;
+        ci.usageFlags = xr::SwapchainUsageFlagBits::TransferDst | xr::SwapchainUsageFlagBits::ColorAttachment;
         ci.format = xrs::DEFAULT_SWAPCHAIN_FORMAT;
         ci.width = (uint32_t)renderTargetSize.width;
         ci.height = (uint32_t)renderTargetSize.height;
@@ -209,38 +388,73 @@ public:
         ci.faceCount = 1;
         ci.mipCount = 1;
 
-        projectionColorSwapchain = xrSession.createSwapchain(ci);
+        if (multiview) {
+            auto arrayCi = ci;
+            arrayCi.width /= 2;
+            arrayCi.arraySize = gl::MultiviewFramebuffer::VIEW_COUNT;
+            try {
+                projectionColorSwapchain = xrSession.createSwapchain(arrayCi);
+            } catch (const std::exception& e) {
+                LOG_WARN("Texture array swapchains aren't supported ({}), falling back to double wide rendering", e.what());
+                multiviewFramebuffer.destroy();
+                multiview = false;
+            }
+        }
+        if (!multiview) {
+            projectionColorSwapchain = xrSession.createSwapchain(ci);
+        }
         projectionFramebuffer.setSwapchain(projectionColorSwapchain);
 
-#if USE_DEPTH_INFO
-        ci.format = xrs::DEFAULT_SWAPCHAIN_DEPTH_FORMAT;
-        projectionDepthSwapchain = xrSession.createSwapchain(ci);
-        projectionFramebuffer.setDepthSwapchain(projectionDepthSwapchain);
-#endif
+        if (submitDepth) {
+            xrs::SwapchainFormatType depthFormat;
+            if (xrs::selectDepthSwapchainFormat(xrSession.enumerateSwapchainFormats(), depthFormat)) {
+                auto depthCi = ci;
+                depthCi.usageFlags = xr::SwapchainUsageFlagBits::DepthStencilAttachment;
+                depthCi.format = (int64_t)depthFormat;
+                if (multiview) {
+                    depthCi.width /= 2;
+                    depthCi.arraySize = gl::MultiviewFramebuffer::VIEW_COUNT;
+                }
+                projectionDepthSwapchain = xrSession.createSwapchain(depthCi);
+                projectionDepthHasStencil = xrs::hasStencil(depthFormat);
+                projectionFramebuffer.setDepthSwapchain(projectionDepthSwapchain, projectionDepthHasStencil);
+            } else {
+                logging::log(logging::Level::Warning,
+                             "The runtime supports no known depth swapchain format, not submitting depth");
+            }
+        }
 
-        projectionFramebuffer.create(renderTargetSize);
+        // A multiview swapchain is only ever copied or rendered into directly, never bound through
+        // `projectionFramebuffer`
+        if (!multiview) {
+            projectionFramebuffer.create(renderTargetSize);
+        }
         projectionLayer.space = space;
         // Finish setting up the layer submission
         xr::for_each_side_index([&](uint32_t eyeIndex) {
             xr::Rect2Di imageRect;
             imageRect.extent = { (int32_t)renderTargetSize.width / 2, (int32_t)renderTargetSize.height };
-            if (eyeIndex == 1) {
+            if (eyeIndex == 1 && !multiview) {
                 imageRect.offset.x = imageRect.extent.width;
             }
 
             auto& layerView = projectionLayerViews[eyeIndex];
             layerView.subImage.swapchain = projectionColorSwapchain;
             layerView.subImage.imageRect = imageRect;
-
-#if USE_DEPTH_INFO
-            auto& depthInfo = projectionDeptInfos[eyeIndex];
-            depthInfo.maxDepth = 1.0f;
-            depthInfo.farZ = farZ;
-            depthInfo.nearZ = nearZ;
-            depthInfo.subImage.swapchain = projectionDepthSwapchain;
-            depthInfo.subImage.imageRect = imageRect;
-            layerView.next = &depthInfo;
-#endif
+            layerView.subImage.imageArrayIndex = multiview ? eyeIndex : 0;
+
+            if (isSubmittingDepth()) {
+                // The depth range and clip planes of the projections from `gl::toGlm(fov, nearZ, farZ)`
+                auto& depthInfo = projectionDepthInfos[eyeIndex];
+                depthInfo.minDepth = 0.0f;
+                depthInfo.maxDepth = 1.0f;
+                depthInfo.nearZ = nearZ;
+                depthInfo.farZ = farZ;
+                depthInfo.subImage.swapchain = projectionDepthSwapchain;
+                depthInfo.subImage.imageRect = imageRect;
+                depthInfo.subImage.imageArrayIndex = layerView.subImage.imageArrayIndex;
+                layerView.next = &depthInfo;
+            }
         });
         layersPointers.push_back(&projectionLayer);
     }
@@ -376,17 +590,28 @@ public:
     virtual bool update(float delta) {
         if (xrContext.stopped) {
             scene.destroy();
+            eyeViewsUniforms.destroy();
+            profiler.destroy();
+            mirror.destroy();
             window.requestClose();
             return false;
         }
-        xrContext.pollEvents();
+        if (isReplaying()) {
+            return updateReplay();
+        }
+        {
+            auto phase = frameTimings.scoped(FramePhase::PollEvents);
+            xrContext.pollEvents();
+        }
 
         bool sessionSynced = false;
         switch (xrContext.state) {
+            // The runtime only moves on from Ready once the frame loop has started submitting frames
+            case xr::SessionState::Ready:
             case xr::SessionState::Focused:
             case xr::SessionState::Visible:
             case xr::SessionState::Synchronized:
-                sessionSynced = true;
+                sessionSynced = xrContext.isSessionRunning();
                 break;
 
             // If we're not in one of the above session states, we're not going to do anything else this frame
@@ -395,27 +620,33 @@ public:
                 //return false;
                 break;
         }
+        window.setLoopInterval(idleScheduler.update(xrContext.state, sessionSynced));
 
         if (sessionSynced) {
-            const xr::ActiveActionSet activeActionSet{ actionSet, xr::Path{ XR_NULL_PATH } };
-            xrSession.syncActions({ 1, &activeActionSet });
-            xrContext.onFrameStart();
-            xrContext.updateEyeViews(space);
-            updateHandStates();
-
-            xr::for_each_side_index([&](size_t eyeIndex) {
-                const auto& viewState = xrContext.eyeViewStates[eyeIndex];
-                eyeStates[eyeIndex] = viewState;
-
-                // Copy the eye states to the projection layer.
-                // Remember when doing asynchronous rendering to carry the eye states to the rendering layer
-                {
-                    auto& projectionLayerView = projectionLayerViews[eyeIndex];
-                    projectionLayerView.fov = viewState.fov;
-                    projectionLayerView.pose = viewState.pose;
-                }
-            });
-            scene.updateEyes(eyeStates);
+            {
+                auto phase = frameTimings.scoped(FramePhase::SyncActions);
+                const xr::ActiveActionSet activeActionSet{ actionSet, xr::Path{ XR_NULL_PATH } };
+                xrSession.syncActions({ 1, &activeActionSet });
+            }
+
+            // Equivalent to `xrContext.onFrameStart()`, split so the wait and begin can be timed separately
+            xrContext.beginFrameResult = xr::Result::FrameDiscarded;
+            bool frameWaited = false;
+            {
+                auto phase = frameTimings.scoped(FramePhase::WaitFrame);
+                frameWaited = xrContext.waitFrame();
+            }
+            if (frameWaited) {
+                auto phase = frameTimings.scoped(FramePhase::BeginFrame);
+                xrContext.beginFrame();
+            }
+            frameTimings.setPredictedDisplayTime(xrContext.frameState.predictedDisplayTime.get());
+
+            updateEyeStates();
+            {
+                auto phase = frameTimings.scoped(FramePhase::UpdateHandStates);
+                updateHandStates();
+            }
             scene.updateHands(handStates);
 
         }
@@ -423,26 +654,222 @@ public:
         return true;
     }
 
-    virtual void renderSceneLayer() final { 
-        framebuffer.bind();
-        framebuffer.clear();
-        scene.render(framebuffer); 
-        framebuffer.bindDefault();
+    bool updateReplay() {
+        if (replayFrame >= inputPlayer.size()) {
+            scene.destroy();
+            eyeViewsUniforms.destroy();
+            profiler.destroy();
+            mirror.destroy();
+            window.requestClose();
+            return false;
+        }
+        const auto& input = inputPlayer.get(replayFrame++);
+        xrContext.frameState.predictedDisplayTime = xr::Time{ input.predictedDisplayTime };
+        xrContext.frameState.predictedDisplayPeriod = xr::Duration{ input.predictedDisplayPeriod };
+        xrContext.frameState.shouldRender = input.shouldRender;
+        frameTimings.setPredictedDisplayTime(input.predictedDisplayTime);
+
+        input.getEyeStates(eyeStates);
+        frameTimings.markPoseLocated();
+        input.getHandStates(handStates);
+        scene.updateEyes(eyeStates);
+        scene.updateHands(handStates);
+        return true;
+    }
+
+    void updateEyeStates() {
+        xrContext.updateEyeViews(space);
+        frameTimings.markPoseLocated();
+
+        xr::for_each_side_index([&](size_t eyeIndex) {
+            const auto& viewState = xrContext.eyeViewStates[eyeIndex];
+            eyeStates[eyeIndex] = viewState;
+
+            // Copy the eye states to the projection layer.
+            // Remember when doing asynchronous rendering to carry the eye states to the rendering layer
+            {
+                auto& projectionLayerView = projectionLayerViews[eyeIndex];
+                projectionLayerView.fov = viewState.fov;
+                projectionLayerView.pose = viewState.pose;
+            }
+        });
+        scene.updateEyes(eyeStates);
     }
 
+    // For the scenes that read the `EyeViews` block, the eye view and projection matrices of the scene layer are
+    // written to `eyeViewsUniforms` every frame, bound at `gl::EyeViewsUniformBuffer::DEFAULT_BINDING`.  With
+    // `lateLatchEyePoses` the views are located again once the scene's draws have been issued, and latched into the
+    // buffer before the draws are flushed.  Other scenes set their views while issuing their draws, so for them the
+    // views are located again just before.  Either way the new poses also go to the projection layer views, so that
+    // the compositor reprojects from exactly the poses that were rendered.
+    gl::EyeViewsUniformBuffer eyeViewsUniforms;
+    virtual void renderSceneLayer() final {
+        if (adaptiveResolution) {
+            updateRenderScale();
+        }
+        auto& sceneFramebuffer = getSceneFramebuffer();
+        if (isRenderingDirectToSwapchain() || isSubmittingDepth()) {
+            projectionFramebuffer.acquire();
+        }
+        // `projectionFramebuffer` selects the FBO of the acquired images itself
+        if (&sceneFramebuffer != &projectionFramebuffer) {
+            if (isRenderingDirectToSwapchain()) {
+                sceneFramebuffer.setColorAttachment(projectionFramebuffer.getColorImage());
+            }
+            if (isSubmittingDepth()) {
+                sceneFramebuffer.setDepthAttachment(projectionFramebuffer.getDepthImage(), projectionDepthHasStencil);
+            }
+        }
+        // Depth only has to reach memory if the compositor reads it, and nothing uses stencil across frames
+        Framebuffer::RenderPass renderPass;
+        renderPass.depth.store = isSubmittingDepth() ? Framebuffer::StoreOp::Store : Framebuffer::StoreOp::Discard;
+        renderPass.stencil = { Framebuffer::LoadOp::DontCare, Framebuffer::StoreOp::Discard };
+        sceneFramebuffer.beginRenderPass(renderPass);
+        const bool latching = lateLatchEyePoses && !isReplaying();
+        const bool eyeViews = scene.readsEyeViews();
+        if (latching && !eyeViews) {
+            updateEyeStates();
+        }
+        if (eyeViews) {
+            eyeViewsUniforms.write(eyeStates, nearZ, farZ);
+            eyeViewsUniforms.bind();
+        }
+        {
+            auto gpuZone = profiler.zone(gl::zone::SCENE);
+            scene.render(sceneFramebuffer);
+        }
+        if (eyeViews) {
+            if (latching) {
+                updateEyeStates();
+                eyeViewsUniforms.latch(eyeStates, nearZ, farZ);
+            }
+            eyeViewsUniforms.advance();
+        }
+        frameTimings.markPoseConsumed();
+        sceneFramebuffer.endRenderPass(renderPass);
+        if (foveated) {
+            renderFoveatedInset(renderPass);
+        }
+    }
+
+    // Renders the inset of each eye with a field of view narrowed to exactly the pixels it covers in the periphery
+    void renderFoveatedInset(const Framebuffer::RenderPass& renderPass) {
+        const auto& eyeSize = framebuffer.getEyeSize();
+        auto insetEyeStates = eyeStates;
+        xr::for_each_side_index([&](uint32_t eyeIndex) {
+            const auto& fov = eyeStates[eyeIndex].fov;
+            insetRects[eyeIndex] = foveation.getInsetRect(eyeSize, fov);
+            insetEyeStates[eyeIndex].fov = Foveation::getInsetFov(eyeSize, fov, insetRects[eyeIndex]);
+        });
+        scene.updateEyes(insetEyeStates);
+        insetFramebuffer.beginRenderPass(renderPass);
+        if (scene.readsEyeViews()) {
+            eyeViewsUniforms.write(insetEyeStates, nearZ, farZ);
+            eyeViewsUniforms.bind();
+        }
+        {
+            auto gpuZone = profiler.zone(gl::zone::FOVEATED_INSET);
+            scene.render(insetFramebuffer);
+        }
+        if (scene.readsEyeViews()) {
+            eyeViewsUniforms.advance();
+        }
+        insetFramebuffer.endRenderPass(renderPass);
+        scene.updateEyes(eyeStates);
+    }
+
+    // Upscales each eye's periphery to the eye's half of `dest`, then copies the inset over it pixel for pixel
+    void compositeFoveated(uint32_t dest) {
+        const auto& eyeSize = framebuffer.getEyeSize();
+        xr::for_each_side_index([&](uint32_t eyeIndex) {
+            xr::Rect2Di eyeRect{ { 0, 0 }, eyeSize };
+            eyeRect.offset.x = eyeSize.width * (int32_t)eyeIndex;
+            Framebuffer::blit(framebuffer.id(), framebuffer.getViewportSide(eyeIndex), dest, eyeRect, Framebuffer::Color,
+                              Framebuffer::Linear);
+            auto insetRect = insetRects[eyeIndex];
+            insetRect.offset.x += eyeRect.offset.x;
+            Framebuffer::blit(insetFramebuffer.id(), insetFramebuffer.getViewportSide(eyeIndex), dest, insetRect,
+                              Framebuffer::Color, Framebuffer::Nearest);
+        });
+    }
+
+    // GPU times of the passes run on the main thread, see `gl::zone`.  The scene zone's queries live on whatever
+    // context `framebuffer.bind()` makes current, the others on the window's context
+    gl::Profiler profiler;
+    void updateRenderScale() {
+        float gpuTime;
+        auto& sceneFramebuffer = getSceneFramebuffer();
+        if (profiler.popZoneTime(gl::zone::SCENE, gpuTime)) {
+            auto budget = (float)xrContext.frameState.predictedDisplayPeriod.get() / 1.0e6f;
+            sceneFramebuffer.setViewportScale(resolutionScaler.update(gpuTime, budget));
+        }
+        // The compositor must only sample the part of each eye's half (or layer) of the swapchain image that was
+        // rendered
+        xr::for_each_side_index([&](uint32_t eyeIndex) {
+            projectionLayerViews[eyeIndex].subImage.imageRect = sceneFramebuffer.getViewportSide(eyeIndex);
+            projectionDepthInfos[eyeIndex].subImage.imageRect = sceneFramebuffer.getViewportSide(eyeIndex);
+        });
+        frameTimings.setRenderScale(sceneFramebuffer.getViewportScale());
+    }
+
+    // Replayed frames have no swapchain to render into
+    bool isRenderingDirectToSwapchain() const { return renderDirectToSwapchain && !isReplaying(); }
+
     virtual void blitToProjection() {
+        if (isRenderingDirectToSwapchain()) {
+            // The scene is already in the swapchain image, which can't be read once it's released, so mirror it now
+            blitMirror();
+            projectionFramebuffer.advance();
+            return;
+        }
+
+        if (multiview) {
+            // Both layers in one copy, into the matching layers of the swapchain image
+            projectionFramebuffer.acquire();
+            {
+                auto gpuZone = profiler.zone(gl::zone::BLIT_TO_PROJECTION);
+                multiviewFramebuffer.copyTo(projectionFramebuffer.getColorImage());
+            }
+            projectionFramebuffer.advance();
+            return;
+        }
+
         // Blit to the swapchain
         projectionFramebuffer.bind();
-        framebuffer.blitTo(projectionFramebuffer.fbo, renderTargetSize);
+        {
+            auto gpuZone = profiler.zone(gl::zone::BLIT_TO_PROJECTION);
+            if (foveated) {
+                compositeFoveated(projectionFramebuffer.fbo);
+            } else {
+                framebuffer.blitTo(projectionFramebuffer.fbo, renderTargetSize);
+            }
+        }
         projectionFramebuffer.bindDefault();
         projectionFramebuffer.advance();
     }
 
     virtual void renderExtraLayers() {}
 
+    gl::Mirror mirror;
+    bool isMirroringFrame() const {
+        return mirrorMode != gl::Mirror::Mode::Off && 0 == (frameCounter % std::max(mirrorInterval, 1u));
+    }
+
+    void blitMirror() {
+        if (!isMirroringFrame()) {
+            return;
+        }
+        auto gpuZone = profiler.zone(gl::zone::MIRROR_BLIT);
+        mirror.update(getSceneFramebuffer(), mirrorMode);
+    }
+
     virtual void blitToWindow() {
-        framebuffer.blitTo(0, window.getSize());
-        window.swapBuffers();
+        if (!isRenderingDirectToSwapchain()) {
+            blitMirror();
+        }
+        if (isMirroringFrame()) {
+            mirror.present();
+        }
     }
 
     virtual void submitFrame() {
@@ -459,25 +886,59 @@ public:
             return;
         }
 
+        if (isReplaying()) {
+            {
+                auto phase = frameTimings.scoped(FramePhase::RenderSceneLayer);
+                renderSceneLayer();
+            }
+            auto phase = frameTimings.scoped(FramePhase::BlitToWindow);
+            blitToWindow();
+            return;
+        }
+
         if (!xrContext.shouldRender()) {
             if (xrContext.beginFrameResult == xr::Result::Success) {
                 xrContext.session.endFrame(
                     xr::FrameEndInfo{ xrContext.frameState.predictedDisplayTime, xr::EnvironmentBlendMode::Opaque });
             }
-            window.swapBuffers();
+            if (idleScheduler.shouldRefreshMirror()) {
+                auto phase = frameTimings.scoped(FramePhase::BlitToWindow);
+                mirror.present();
+            }
             return;
         }
 
-        renderSceneLayer();
-        blitToProjection();
-
-        renderExtraLayers();
+        {
+            auto phase = frameTimings.scoped(FramePhase::RenderSceneLayer);
+            renderSceneLayer();
+        }
+        if (inputRecorder.isOpen()) {
+            // After the scene layer, so that late latched eye poses are the ones recorded
+            FrameInput input;
+            input.set(xrContext.frameState, eyeStates, handStates);
+            inputRecorder.write(input);
+        }
+        {
+            auto phase = frameTimings.scoped(FramePhase::BlitToProjection);
+            blitToProjection();
+        }
+        {
+            auto phase = frameTimings.scoped(FramePhase::RenderExtraLayers);
+            auto gpuZone = profiler.zone(gl::zone::EXTRA_LAYERS);
+            renderExtraLayers();
+        }
 
         // Submit the image layers
-        submitFrame();
+        {
+            auto phase = frameTimings.scoped(FramePhase::SubmitFrame);
+            submitFrame();
+        }
 
         // Blit to the window
-        blitToWindow();
+        {
+            auto phase = frameTimings.scoped(FramePhase::BlitToWindow);
+            blitToWindow();
+        }
     }
 
     virtual std::string getWindowTitle() {
@@ -504,12 +965,23 @@ public:
             }
             tStart = tEnd;
             ++frameCounter;
+            frameTimings.beginFrame(frameCounter);
             if (!update((float)tDiff / 1000.0f)) {
-                Sleep(100);
                 return;
             }
             render();
+            // Idle iterations aren't frames, and would only drown the frame statistics
+            if (!idleScheduler.isIdle()) {
+                frameTimings.endFrame();
+            }
         });
+
+        inputRecorder.close();
+        frameTimings.logSummary();
+        profiler.logSummary("GPU");
+        if (!frameTimingsPath.empty()) {
+            frameTimings.write(frameTimingsPath);
+        }
     }
 };
 }  // namespace xr_examples
\ No newline at end of file
@@ -0,0 +1,88 @@
+//
+//  Created by Bradley Austin Davis
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#include "parallelFor.hpp"
+
+#include <algorithm>
+
+using namespace xr_examples;
+
+void ParallelFor::setThreadCount(uint32_t threadCount) {
+    threadCount = std::clamp<uint32_t>(threadCount, 1, MAX_THREADS);
+    if (threadCount == getThreadCount()) {
+        return;
+    }
+
+    if (!workers.empty()) {
+        {
+            Lock lock{ mutex };
+            quit = true;
+        }
+        startConditional.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        workers.clear();
+        quit = false;
+    }
+
+    // Workers only run generations after the current one, which may have been bumped before they get to wait
+    for (uint32_t thread = 1; thread < threadCount; ++thread) {
+        workers.emplace_back([this, thread, lastGeneration = generation] { runWorker(thread, lastGeneration); });
+    }
+}
+
+void ParallelFor::run(size_t count, const Task& task) {
+    if (count == 0) {
+        return;
+    }
+    if (workers.empty()) {
+        task(0, 0, count);
+        return;
+    }
+
+    {
+        Lock lock{ mutex };
+        this->task = &task;
+        this->count = count;
+        pending = (uint32_t)workers.size();
+        ++generation;
+    }
+    startConditional.notify_all();
+    runChunk(0);
+
+    Lock lock{ mutex };
+    doneConditional.wait(lock, [this] { return pending == 0; });
+    this->task = nullptr;
+}
+
+void ParallelFor::runChunk(uint32_t thread) {
+    auto threadCount = (size_t)getThreadCount();
+    auto begin = count * thread / threadCount;
+    auto end = count * (thread + 1) / threadCount;
+    if (begin != end) {
+        (*task)(thread, begin, end);
+    }
+}
+
+void ParallelFor::runWorker(uint32_t thread, uint64_t lastGeneration) {
+    while (true) {
+        {
+            Lock lock{ mutex };
+            startConditional.wait(lock, [&] { return quit || generation != lastGeneration; });
+            if (quit) {
+                return;
+            }
+            lastGeneration = generation;
+        }
+        runChunk(thread);
+        {
+            Lock lock{ mutex };
+            --pending;
+        }
+        doneConditional.notify_one();
+    }
+}
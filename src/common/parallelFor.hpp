@@ -0,0 +1,55 @@
+//
+//  Created by Bradley Austin Davis
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace xr_examples {
+
+// Fork-join over an index range, on a fixed set of persistent threads plus the calling one.  `run()` splits the
+// range into one contiguous chunk per thread, and only returns once every chunk is done, so the task can read
+// whatever the caller set up beforehand, and write per-thread results the caller reads afterwards, without any
+// further synchronization.  Not reentrant: a task must not call `run()` on the same instance.
+class ParallelFor {
+public:
+    // `thread` is in [0, getThreadCount()), and 0 is always the calling thread
+    using Task = std::function<void(uint32_t thread, size_t begin, size_t end)>;
+    static constexpr uint32_t MAX_THREADS = 64;
+
+    ~ParallelFor() { setThreadCount(1); }
+
+    // Clamped to [1, MAX_THREADS].  One thread runs everything on the calling thread
+    void setThreadCount(uint32_t threadCount);
+    uint32_t getThreadCount() const { return (uint32_t)workers.size() + 1; }
+    void run(size_t count, const Task& task);
+
+private:
+    using Lock = std::unique_lock<std::mutex>;
+
+    void runWorker(uint32_t thread, uint64_t lastGeneration);
+    void runChunk(uint32_t thread);
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable startConditional;
+    std::condition_variable doneConditional;
+    // Guarded by `mutex`.  Each `run()` bumps the generation, which is what wakes the workers
+    uint64_t generation{ 0 };
+    uint32_t pending{ 0 };
+    bool quit{ false };
+    // Only written by `run()` and `setThreadCount()`, while no worker is running a chunk
+    const Task* task{ nullptr };
+    size_t count{ 0 };
+};
+
+}  // namespace xr_examples
@@ -23,6 +23,7 @@
 #include <QtGui/QOpenGLDebugLogger>
 #include <QtGui/qopenglfunctions_4_5_core.h>
 
+#include <gl/fence.hpp>
 #include <gl/framebuffer.hpp>
 
 #include <qt/math.hpp>
@@ -48,17 +49,37 @@ struct Framebuffer::Private {
 
     QOpenGLContext* context{ nullptr };
     SizedOffscreenSurface* offscreenSurface{ nullptr };
+    // An FBO over a set of attachments.  Zero for `depth` means `offscreenDepthStencil`
+    struct Target {
+        uint32_t color{ 0 };
+        uint32_t depth{ 0 };
+        bool depthHasStencil{ true };
+        uint32_t fbo{ 0 };
+    };
+
     gl::Framebuffer windowFramebuffer;
-    uint32_t offscreenFbo{ 0 };
     uint32_t offscreenDepthStencil{ 0 };
+    // The attachments set with `setColorAttachment` and `setDepthAttachment`
+    uint32_t color{ 0 };
+    uint32_t depth{ 0 };
+    bool depthHasStencil{ true };
+    // Framebuffer objects aren't shared between contexts, so there are separate FBOs for the offscreen context, which
+    // renders, and the parent context, which only reads the color buffer.  There's one for every combination of
+    // attachments used so far, e.g. one per swapchain image, so that cycling through the images of a swapchain just
+    // selects FBOs instead of re-attaching the images.  Each is created the next time its context is current
+    std::vector<Target> offscreenTargets;
+    std::vector<Target> windowTargets;
+    // The offscreen FBO last bound
+    uint32_t offscreenFbo{ 0 };
 
     bool makeCurrent() { return context->makeCurrent(offscreenSurface); }
 
     bool makeParentCurrent() { return parentContext->makeCurrent(parentSurface); }
 
-    Private(const xr::Extent2Di& size) {
+    Private(const xr::Extent2Di& size, bool externalColor) {
         parentContext = QOpenGLContext::currentContext();
         parentSurface = parentContext->surface();
+        windowFramebuffer.setExternalColor(externalColor);
         windowFramebuffer.create(size);
 
         context = new QOpenGLContext();
@@ -89,9 +110,8 @@ struct Framebuffer::Private {
         glf.glCreateRenderbuffers(1, &offscreenDepthStencil);
         glf.glNamedRenderbufferStorage(offscreenDepthStencil, GL_DEPTH24_STENCIL8, size.width, size.height);
 
-        glf.glCreateFramebuffers(1, &offscreenFbo);
-        glf.glNamedFramebufferRenderbuffer(offscreenFbo, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, offscreenDepthStencil);
-        glf.glNamedFramebufferTexture(offscreenFbo, GL_COLOR_ATTACHMENT0, windowFramebuffer.color, 0);
+        color = windowFramebuffer.color;
+        offscreenFbo = getOffscreenFbo();
 
         if (!makeParentCurrent()) {
             qFatal("Offscreen surface can't restore old context");
@@ -102,6 +122,51 @@ struct Framebuffer::Private {
         g_sceneSurface = offscreenSurface;
     }
 
+    // Must be called with the offscreen context current
+    uint32_t getOffscreenFbo() {
+        for (const auto& target : offscreenTargets) {
+            if (target.color == color && target.depth == depth && target.depthHasStencil == depthHasStencil) {
+                return target.fbo;
+            }
+        }
+
+        auto& glf = getFunctions();
+        Target target{ color, depth, depthHasStencil };
+        glf.glCreateFramebuffers(1, &target.fbo);
+        glf.glNamedFramebufferTexture(target.fbo, GL_COLOR_ATTACHMENT0, color, 0);
+        if (depth == 0) {
+            glf.glNamedFramebufferRenderbuffer(target.fbo, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER,
+                                               offscreenDepthStencil);
+        } else {
+            auto attachment = depthHasStencil ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+            glf.glNamedFramebufferTexture(target.fbo, attachment, depth, 0);
+        }
+        offscreenTargets.push_back(target);
+        return target.fbo;
+    }
+
+    // Must be called with the parent context current.  Only the color attachment matters here, as the window FBOs
+    // are only read from, and share the window framebuffer's depth buffer
+    uint32_t getWindowFbo() {
+        if (color == windowFramebuffer.color) {
+            return windowFramebuffer.fbo;
+        }
+        for (const auto& target : windowTargets) {
+            if (target.color == color) {
+                return target.fbo;
+            }
+        }
+
+        auto& glf = getFunctions();
+        Target target{ color };
+        glf.glCreateFramebuffers(1, &target.fbo);
+        glf.glNamedFramebufferTexture(target.fbo, GL_COLOR_ATTACHMENT0, color, 0);
+        glf.glNamedFramebufferRenderbuffer(target.fbo, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER,
+                                           windowFramebuffer.depthStencil);
+        windowTargets.push_back(target);
+        return target.fbo;
+    }
+
     ~Private() {
         context->doneCurrent();
         context->deleteLater();
@@ -114,15 +179,28 @@ void Framebuffer::create(const xr::Extent2Di& size) {
     this->size = size;
     this->eyeSize = size;
     eyeSize.width /= 2;
-    d = std::make_shared<Private>(size);
+    d = std::make_shared<Private>(size, externalColor);
 }
 
 void Framebuffer::bind(Target target) {
     d->makeCurrent();
     auto& glf = getFunctions();
+    d->offscreenFbo = d->getOffscreenFbo();
     auto gltarget = target == Draw ? GL_DRAW_FRAMEBUFFER : GL_READ_FRAMEBUFFER;
     glf.glBindFramebuffer(gltarget, d->offscreenFbo);
 }
+
+void Framebuffer::beginRenderPass(const RenderPass& renderPass) {
+    bind();
+    applyLoadOps(d->offscreenFbo, renderPass);
+}
+
+void Framebuffer::endRenderPass(const RenderPass& renderPass) {
+    // The ops apply to the offscreen FBO, so they have to be issued before switching back to the parent context
+    applyStoreOps(d->offscreenFbo, renderPass);
+    bindDefault();
+}
+
 void Framebuffer::clear(const xr::Color4f& color, float depth, int stencil) {
     auto& glf = getFunctions();
     glf.glClearColor(color.r, color.g, color.b, color.a);
@@ -133,12 +211,15 @@ void Framebuffer::clear(const xr::Color4f& color, float depth, int stencil) {
 
 void Framebuffer::bindDefault(Target target) {
     auto& glf = getFunctions();
-    glf.glFlush();
-    glf.glFinish();
+    // The parent context only has to see the offscreen rendering before its own commands that read it, so the GPU
+    // waits for it there, rather than draining the pipeline on the CPU
+    gl::Fence handoff;
+    handoff.insert();
 
     d->makeParentCurrent();
+    handoff.gpuWait();
     auto gltarget = target == Draw ? GL_DRAW_FRAMEBUFFER : GL_READ_FRAMEBUFFER;
-    glf.glBindFramebuffer(gltarget, d->windowFramebuffer.fbo);
+    glf.glBindFramebuffer(gltarget, d->getWindowFbo());
 }
 void Framebuffer::setViewport(const xr::Rect2Di& vp) {
     auto& glf = getFunctions();
@@ -146,7 +227,25 @@ void Framebuffer::setViewport(const xr::Rect2Di& vp) {
 }
 
 uint32_t Framebuffer::id() {
-    return d->windowFramebuffer.id();
+    return d->getWindowFbo();
+}
+
+void Framebuffer::setColorAttachment(uint32_t texture) {
+    if (texture == 0 && d->windowFramebuffer.color == 0) {
+        // Allocates the window framebuffer's color buffer, see `setExternalColor()`
+        d->windowFramebuffer.setColorAttachment(0);
+    }
+    d->color = texture != 0 ? texture : d->windowFramebuffer.color;
+}
+
+uint32_t Framebuffer::getColorTexture() const {
+    return d->color;
+}
+
+void Framebuffer::setDepthAttachment(uint32_t texture, bool hasStencil) {
+    // Only the offscreen FBO is rendered with, so the window FBOs keep the window framebuffer's depth buffer
+    d->depth = texture;
+    d->depthHasStencil = texture == 0 || hasStencil;
 }
 
 }}  // namespace xr_examples::qt
@@ -15,10 +15,15 @@ public:
     void create(const xr::Extent2Di& size) override;
     void destroy() override { d.reset(); }
     void bind(Target target = Draw) override;
+    void beginRenderPass(const RenderPass& renderPass) override;
+    void endRenderPass(const RenderPass& renderPass) override;
     void clear(const xr::Color4f& color = { 0, 0, 0, 1 }, float depth = 1.0f, int stencil = 0) override;
     void bindDefault(Target target = Draw) override;
     void setViewport(const xr::Rect2Di& viewport) override;
     uint32_t id() override;
+    void setColorAttachment(uint32_t texture) override;
+    void setDepthAttachment(uint32_t texture, bool hasStencil = true) override;
+    uint32_t getColorTexture() const override;
 
 private:
     std::shared_ptr<Private> d;
@@ -11,9 +11,11 @@
 #if defined(HAVE_QT)
 
 #include <QtCore/QCoreApplication>
+#include <QtCore/QDebug>
 #include <QtQuick/QQuickWindow>
 #include <QtGui/qopenglfunctions_4_5_core.h>
 
+#include <gl/fence.hpp>
 #include <qt/gl.hpp>
 #include <qt/qml/impl/sharedObject.hpp>
 #include <qt/qml/impl/renderControl.hpp>
@@ -79,15 +81,35 @@ void RenderEventHandler::onInitalize() {
         qFatal("Unable to make QML rendering context current on render thread");
     }
     auto& glf = qt::getFunctions();
-    glf.glCreateFramebuffers(1, &_fbo);
     glf.glCreateRenderbuffers(1, &_depthBuffer);
     glf.glNamedRenderbufferStorage(_depthBuffer, GL_DEPTH24_STENCIL8, _shared->_size.width(), _shared->_size.height());
-    glf.glNamedFramebufferRenderbuffer(_fbo, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, _depthBuffer);
 
     _shared->_renderControl->initialize(&_context);
     _initialized = true;
 }
 
+void RenderEventHandler::createFramebuffers() {
+    destroyFramebuffers();
+    const auto& images = _shared->_swapchainImages;
+    auto& glf = qt::getFunctions();
+    _fbos.resize(images.size());
+    glf.glCreateFramebuffers((GLsizei)_fbos.size(), _fbos.data());
+    for (size_t i = 0; i < _fbos.size(); ++i) {
+        glf.glNamedFramebufferTexture(_fbos[i], GL_COLOR_ATTACHMENT0, images[i].image, 0);
+        glf.glNamedFramebufferRenderbuffer(_fbos[i], GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, _depthBuffer);
+        if (glf.glCheckNamedFramebufferStatus(_fbos[i], GL_DRAW_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            qFatal("QML swapchain framebuffer incomplete");
+        }
+    }
+}
+
+void RenderEventHandler::destroyFramebuffers() {
+    if (!_fbos.empty()) {
+        qt::getFunctions().glDeleteFramebuffers((GLsizei)_fbos.size(), _fbos.data());
+        _fbos.clear();
+    }
+}
+
 void RenderEventHandler::onRender() {
     qmlRender(false);
 }
@@ -101,30 +123,40 @@ void RenderEventHandler::qmlRender(bool sceneGraphSync) {
         return;
     }
 
-    if (&_context != QOpenGLContext::currentContext()) {
-        qFatal("QML rendering context not current on render thread");
+    // Other surfaces may have rendered on this thread since, with their own contexts
+    if (!_context.makeCurrent(&_surface)) {
+        qFatal("Unable to make QML rendering context current on render thread");
     }
 
     if (!_shared->preRender(sceneGraphSync)) {
         return;
     }
 
+    // The swapchain may be set after initialization, so the framebuffers are built the first time it's rendered to
+    if (_fbos.size() != _shared->_swapchainImages.size()) {
+        createFramebuffers();
+    }
+
     auto& swapchain = _shared->_swapchain;
     auto index = swapchain.acquireSwapchainImage({});
-    auto& swapchainImage = _shared->_swapchainImages[index];
+    auto fbo = _fbos[index];
     swapchain.waitSwapchainImage({ xr::Duration::infinite() });
 
     auto& glf = qt::getFunctions();
 
-    glf.glNamedFramebufferTexture(_fbo, GL_COLOR_ATTACHMENT0, swapchainImage.image, 0);
-    glf.glBindFramebuffer(GL_DRAW_FRAMEBUFFER, _fbo);
+    glf.glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo);
     glf.glClearColor(1, 0, 1, 1);
     glf.glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    _shared->_quickWindow->setRenderTarget(_fbo, _shared->_size);
+    _shared->_quickWindow->setRenderTarget(fbo, _shared->_size);
     _shared->_renderControl->render();
     glf.glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
-    glf.glFlush();
-    glf.glFinish();
+    // The compositor may sample the image as soon as it's released, so the rendering has to be complete by then.
+    // Waiting on a fence only blocks this thread, never the frame loop
+    gl::Fence rendered;
+    rendered.insert();
+    if (!rendered.clientWait()) {
+        qWarning() << "Timed out waiting for the QML rendering to complete";
+    }
     swapchain.releaseSwapchainImage({});
     _shared->_quickWindow->resetOpenGLState();
     _shared->_lastRenderTime = std::chrono::high_resolution_clock::now();
@@ -132,17 +164,21 @@ void RenderEventHandler::qmlRender(bool sceneGraphSync) {
 
 void RenderEventHandler::onQuit() {
     if (_initialized) {
-        if (&_context != QOpenGLContext::currentContext()) {
-            qFatal("QML rendering context not current on render thread");
+        if (!_context.makeCurrent(&_surface)) {
+            qFatal("Unable to make QML rendering context current on render thread");
         }
 
+        destroyFramebuffers();
+        qt::getFunctions().glDeleteRenderbuffers(1, &_depthBuffer);
+        _depthBuffer = 0;
         _shared->_swapchain.destroy();
         _shared->shutdownRendering();
         _context.doneCurrent();
     }
     _context.moveToThread(qApp->thread());
     moveToThread(qApp->thread());
-    QThread::currentThread()->quit();
+    // The thread is shared with other surfaces, so it's only quit once the last of them has released it
+    _shared->renderingStopped();
 }
 
 #endif
\ No newline at end of file
@@ -9,6 +9,8 @@
 
 #if defined(HAVE_QT)
 
+#include <vector>
+
 #include <QtCore/QObject>
 #include <QtCore/QThread>
 #include <QtGui/QOffscreenSurface>
@@ -32,7 +34,7 @@ public:
 };
 
 /* The render event handler lives on the QML rendering thread for a given surface
- * (each surface has a dedicated rendering thread) and handles events of type 
+ * (shared with other surfaces, see `MAX_RENDER_THREADS`) and handles events of type 
  * OffscreenEvent to do one time initialization or destruction, and to actually 
  * perform the render.  
  */
@@ -47,10 +49,13 @@ private:
     void onRenderSync();
     void qmlRender(bool sceneGraphSync);
     void onQuit();
+    void createFramebuffers();
+    void destroyFramebuffers();
 
     SharedObject* const _shared;
     QOpenGLContext _context;
-    uint32_t _fbo{ 0 };
+    // One FBO per swapchain image, so the acquired image never has to be attached to a framebuffer while rendering
+    std::vector<uint32_t> _fbos;
     uint32_t _depthBuffer{ 0 };
     QOffscreenSurface _surface;
     bool _initialized { false };
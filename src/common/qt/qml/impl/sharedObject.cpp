@@ -14,6 +14,9 @@
 #include <QtCore/QTimer>
 #include <QtCore/QPointer>
 
+#include <algorithm>
+#include <vector>
+
 #include <QtGui/QOpenGLContext>
 
 #include <QtQuick/QQuickWindow>
@@ -32,6 +35,11 @@
 // This has the effect of capping the framerate at 200
 static const int MIN_TIMER_MS = 5;
 
+// QML surfaces share this many rendering threads between them, rather than each having one of its own, so that a
+// scene with many overlay surfaces doesn't end up with as many mostly idle threads.  Each surface still renders with
+// a context of its own, since its render control holds on to it
+static const size_t MAX_RENDER_THREADS = 2;
+
 using namespace xr_examples::qml;
 using namespace xr_examples::qml::impl;
 
@@ -46,6 +54,47 @@ extern QOpenGLContext* qt_gl_global_share_context();
 //    return g_sharedSession;
 //}
 
+namespace {
+
+struct RenderThread {
+    QThread* thread{ nullptr };
+    size_t surfaces{ 0 };
+};
+
+// Only touched on the main thread
+std::vector<RenderThread> renderThreads;
+
+QThread* acquireRenderThread(const QString& name) {
+    Q_ASSERT(QThread::currentThread() == qApp->thread());
+    auto leastBusy = std::min_element(renderThreads.begin(), renderThreads.end(),
+                                      [](const auto& a, const auto& b) { return a.surfaces < b.surfaces; });
+    if (leastBusy == renderThreads.end() || (leastBusy->surfaces != 0 && renderThreads.size() < MAX_RENDER_THREADS)) {
+        RenderThread renderThread;
+        renderThread.thread = new QThread();
+        renderThread.thread->setObjectName(name);
+        renderThread.thread->start();
+        renderThreads.push_back(renderThread);
+        leastBusy = renderThreads.end() - 1;
+    }
+    ++leastBusy->surfaces;
+    return leastBusy->thread;
+}
+
+void releaseRenderThread(QThread* thread) {
+    Q_ASSERT(QThread::currentThread() == qApp->thread());
+    auto itr = std::find_if(renderThreads.begin(), renderThreads.end(),
+                            [&](const auto& renderThread) { return renderThread.thread == thread; });
+    if (itr == renderThreads.end() || 0 != --itr->surfaces) {
+        return;
+    }
+    thread->quit();
+    thread->wait();
+    delete thread;
+    renderThreads.erase(itr);
+}
+
+}  // namespace
+
 SharedObject::SharedObject() {
     // Create render control
     _renderControl = new RenderControl();
@@ -133,10 +182,8 @@ void SharedObject::setRootItem(QQuickItem* rootItem) {
     _rootItem = rootItem;
     _rootItem->setSize(_quickWindow->size());
 
-    // Create the render thread
-    _renderThread = new QThread();
-    _renderThread->setObjectName(objectName());
-    _renderThread->start();
+    // Pick a render thread, shared with other surfaces
+    _renderThread = acquireRenderThread(objectName());
 
     // Create event handler for the render thread
     _renderObject = new RenderEventHandler(this, _renderThread);
@@ -173,15 +220,16 @@ void SharedObject::destroy() {
         _quit = true;
         if (_renderObject) {
             QCoreApplication::postEvent(_renderObject, new OffscreenEvent(OffscreenEvent::Quit), Qt::HighEventPriority);
+            // Block until the rendering thread has shut down this surface, the thread itself may still be rendering
+            // others
+            // FIXME this is undesirable because this is blocking the main thread,
+            // but I haven't found a reliable way to do this only at application
+            // shutdown
+            wait();
         }
     }
-    // Block until the rendering thread has stopped
-    // FIXME this is undesirable because this is blocking the main thread,
-    // but I haven't found a reliable way to do this only at application
-    // shutdown
     if (_renderThread) {
-        _renderThread->wait();
-        delete _renderThread;
+        releaseRenderThread(_renderThread);
         _renderThread = nullptr;
     }
 }
@@ -306,6 +354,10 @@ bool SharedObject::preRender(bool sceneGraphSync) {
 void SharedObject::shutdownRendering() {
     QMutexLocker locker(&_mutex);
     _renderControl->invalidate();
+}
+
+void SharedObject::renderingStopped() {
+    QMutexLocker locker(&_mutex);
     wake();
 }
 
@@ -73,6 +73,8 @@ private:
     bool event(QEvent* e) override;
     bool preRender(bool sceneGraphSync);
     void shutdownRendering();
+    // Called by the render event handler once it's done with the rendering thread, to unblock `destroy()`
+    void renderingStopped();
 
     QQmlEngine* acquireEngine(OffscreenSurface* surface);
     void releaseEngine(QQmlEngine* engine);
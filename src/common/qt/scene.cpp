@@ -74,6 +74,8 @@ struct StereoRenderer {
     Qt3DRender::QRenderAspect* m_renderAspect{ new Qt3DRender::QRenderAspect(Qt3DRender::QRenderAspect::Synchronous) };
     Qt3DRender::QRenderAspectPrivate* m_renderAspectPrivate{ nullptr };
     Qt3DRender::QRenderSurfaceSelector* m_renderSurfaceSelector{ nullptr };
+    std::array<Qt3DRender::QViewport*, 2> m_viewports{};
+    float m_viewportScale{ 1.0f };
 
     StereoRenderer(const std::array<Qt3DRender::QCamera*, 2>& cameras) {
         m_aspectEngine->registerAspect(m_renderAspect);
@@ -87,11 +89,11 @@ struct StereoRenderer {
         m_renderSurfaceSelector->setSurface(g_sceneSurface);
         for (uint32_t eyeIndex = 0; eyeIndex < 2; ++eyeIndex) {
             auto stereoViewport = new Qt3DRender::QViewport(m_renderSurfaceSelector);
-            QRectF viewport = QRectF(eyeIndex == 0 ? 0.0 : 0.5, 0.0, 0.5, 1.0);
-            stereoViewport->setNormalizedRect(viewport);
+            m_viewports[eyeIndex] = stereoViewport;
             auto cameraSelector = new Qt3DRender::QCameraSelector(stereoViewport);
             cameraSelector->setCamera(cameras[eyeIndex]);
         }
+        updateViewports();
         renderSettings->pickingSettings()->setPickMethod(Qt3DRender::QPickingSettings::BoundingVolumePicking);
         renderSettings->pickingSettings()->setPickResultMode(Qt3DRender::QPickingSettings::NearestPick);
         renderSettings->setActiveFrameGraph(m_renderSurfaceSelector);
@@ -101,6 +103,22 @@ struct StereoRenderer {
         m_aspectEngine->setRootEntity(root);
     }
 
+    // Matches `Framebuffer::getViewportSide`.  Qt3D's normalized rects have their origin at the top left, so the
+    // scaled viewports are pushed down to the bottom of each eye's half
+    void setViewportScale(float scale) {
+        if (scale != m_viewportScale) {
+            m_viewportScale = scale;
+            updateViewports();
+        }
+    }
+
+    void updateViewports() {
+        for (uint32_t eyeIndex = 0; eyeIndex < 2; ++eyeIndex) {
+            QRectF viewport = QRectF(eyeIndex == 0 ? 0.0 : 0.5, 1.0 - m_viewportScale, 0.5 * m_viewportScale, m_viewportScale);
+            m_viewports[eyeIndex]->setNormalizedRect(viewport);
+        }
+    }
+
     ~StereoRenderer() {
         // Clean up after ourselves.
         m_aspectEngine->setRootEntity(Qt3DCore::QEntityPtr());
@@ -476,7 +494,8 @@ struct Scene::Private {
         m_sceneRootEntity->setParent(m_stereoRenderer->m_aspectEngine->rootEntity().data());
     }
 
-    void render(const xr::Extent2Di& size) {
+    void render(const xr::Extent2Di& size, float viewportScale) {
+        m_stereoRenderer->setViewportScale(viewportScale);
         m_stereoRenderer->m_renderSurfaceSelector->setExternalRenderTargetSize({size.width, size.height});
         m_stereoRenderer->m_aspectEngine->processFrame();
         m_stereoRenderer->m_renderAspectPrivate->renderSynchronous(false);
@@ -593,13 +612,13 @@ void Scene::updateEyes(const EyeStates& views) {
         Qt3DRender::QCamera* eyeCamera = d->m_cameras[index];
         eyeCamera->transform()->setMatrix(fromXr(eyeView.pose));
         // And a projection matrix
-        eyeCamera->lens()->setProjectionMatrix(fromXrGL(eyeView.fov));
+        eyeCamera->lens()->setProjectionMatrix(fromXrGL(eyeView.fov, nearZ, farZ));
     });
 }
 
 void Scene::render(Framebuffer& framebuffer) {
     //QCoreApplication::processEvents();
-    d->render(framebuffer.getSize());
+    d->render(framebuffer.getSize(), framebuffer.getViewportScale());
 }
 }}  // namespace xr_examples::qt
 
@@ -11,6 +11,8 @@ class Scene : public ::xr_examples::Scene {
 
 public:
     Scene();
+    // Qt3D always renders to the offscreen surface of the one `qt::Framebuffer`
+    bool supportsFoveation() const override { return false; }
     void render(Framebuffer& stereoFramebuffer) override;
     void create() override;
     void setCubemap(const std::string& cubemapPrefix) override;
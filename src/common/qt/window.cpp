@@ -53,6 +53,8 @@ void xr_examples::qt::Window::init() {
 struct Window::Private {
     QWindow* window{ nullptr };
     QOpenGLContext* context{ nullptr };
+    // Only valid while the window loop is running
+    QTimer* loopTimer{ nullptr };
 
     Private() {
         window = new QWindow();
@@ -136,14 +138,22 @@ void Window::setTitle(const std::string& title) const {
     d->window->setTitle(title.c_str());
 }
 
+void Window::setLoopInterval(uint32_t milliseconds) {
+    if (d->loopTimer && d->loopTimer->interval() != (int)milliseconds) {
+        d->loopTimer->setInterval((int)milliseconds);
+    }
+}
+
 void Window::runWindowLoop(const std::function<void()>& handler) {
     QTimer timer;
     timer.setInterval(0);
     timer.setSingleShot(false);
     auto connection = QObject::connect(&timer, &QTimer::timeout, handler);
     QObject::connect(qApp, &QCoreApplication::aboutToQuit, [&] { QObject::disconnect(connection); });
+    d->loopTimer = &timer;
     timer.start();
     qApp->exec();
+    d->loopTimer = nullptr;
 }
 
 }}  // namespace xr_examples::qt
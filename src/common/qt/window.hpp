@@ -22,6 +22,7 @@ public:
     void* getNativeContextHandle();
 
     void setTitle(const std::string& title) const override;
+    void setLoopInterval(uint32_t milliseconds) override;
     void runWindowLoop(const std::function<void()>& handler) override;
     void swapBuffers() const override;
     void requestClose() override;
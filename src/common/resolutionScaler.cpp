@@ -0,0 +1,56 @@
+//
+//  Created by Bradley Austin Davis
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#include "resolutionScaler.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace xr_examples;
+
+void ResolutionScaler::reset() {
+    scale = maxScale;
+    framesBelowGrowThreshold = 0;
+    framesSinceChange = 0;
+}
+
+float ResolutionScaler::adjust(float gpuTime, float targetTime) {
+    auto factor = std::sqrt(targetTime / gpuTime);
+    auto newScale = std::min(std::max(scale * factor, scale - maxStep), scale + maxStep);
+    newScale = std::min(std::max(newScale, minScale), maxScale);
+    if (newScale != scale) {
+        scale = newScale;
+        framesSinceChange = 0;
+    }
+    framesBelowGrowThreshold = 0;
+    return scale;
+}
+
+float ResolutionScaler::update(float gpuTime, float budget) {
+    if (gpuTime <= 0.0f || budget <= 0.0f) {
+        return scale;
+    }
+
+    ++framesSinceChange;
+    if (framesSinceChange <= settleFrames) {
+        return scale;
+    }
+
+    // Aim for the middle of the hysteresis band
+    auto targetTime = budget * (shrinkThreshold + growThreshold) * 0.5f;
+    if (gpuTime > budget * shrinkThreshold) {
+        return adjust(gpuTime, targetTime);
+    }
+
+    if (gpuTime < budget * growThreshold) {
+        if (++framesBelowGrowThreshold >= growFrames) {
+            return adjust(gpuTime, targetTime);
+        }
+    } else {
+        framesBelowGrowThreshold = 0;
+    }
+    return scale;
+}
@@ -0,0 +1,45 @@
+//
+//  Created by Bradley Austin Davis
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#pragma once
+
+#include <cstdint>
+
+namespace xr_examples {
+
+// Picks a per-axis render scale from measured GPU frame times.  The GPU time is compared against the frame
+// budget: above `shrinkThreshold` of the budget the scale drops immediately, and only after `growFrames`
+// consecutive measurements below `growThreshold` does it grow again.  The gap between the two thresholds is the
+// hysteresis that keeps the scale from oscillating.  Since the cost of a frame is roughly proportional to its pixel
+// count, each adjustment moves the scale by the square root of the ratio between the target and measured times,
+// limited to `maxStep` per adjustment.
+class ResolutionScaler {
+public:
+    float minScale{ 0.5f };
+    float maxScale{ 1.0f };
+    float shrinkThreshold{ 0.9f };
+    float growThreshold{ 0.7f };
+    float maxStep{ 0.1f };
+    uint32_t growFrames{ 30 };
+    // GPU timings lag a few frames behind, so after each change the controller waits this many measurements before
+    // considering another one
+    uint32_t settleFrames{ 4 };
+
+    // Feed a new GPU time measurement for the work being scaled, and the time available for it, both in
+    // milliseconds.  Returns the new scale
+    float update(float gpuTime, float budget);
+    float getScale() const { return scale; }
+    void reset();
+
+private:
+    float adjust(float gpuTime, float targetTime);
+
+    float scale{ 1.0f };
+    uint32_t framesBelowGrowThreshold{ 0 };
+    uint32_t framesSinceChange{ 0 };
+};
+
+}  // namespace xr_examples
@@ -0,0 +1,57 @@
+//
+//  Created by Bradley Austin Davis
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace xr_examples {
+
+// Bounded lock-free queue for exactly one producer thread and one consumer thread.  The producer only ever writes
+// `head` and the consumer only ever writes `tail`, so neither side waits on the other, and each index lives on its
+// own cache line so the two threads don't contend for it.  `Capacity` must be a power of two.
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity != 0 && (Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+public:
+    static constexpr size_t CAPACITY = Capacity;
+
+    // Producer only.  Returns false, and drops the value, if the queue is full
+    bool push(const T& value) {
+        auto currentHead = head.load(std::memory_order_relaxed);
+        if (currentHead - tail.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+        slots[currentHead & (Capacity - 1)] = value;
+        head.store(currentHead + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only.  Returns false if the queue is empty
+    bool pop(T& value) {
+        auto currentTail = tail.load(std::memory_order_relaxed);
+        if (head.load(std::memory_order_acquire) == currentTail) {
+            return false;
+        }
+        value = slots[currentTail & (Capacity - 1)];
+        tail.store(currentTail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Only a snapshot, either side may change it right after
+    size_t size() const { return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire); }
+    bool empty() const { return size() == 0; }
+
+private:
+    std::array<T, Capacity> slots{};
+    alignas(64) std::atomic<size_t> head{ 0 };
+    alignas(64) std::atomic<size_t> tail{ 0 };
+};
+
+}  // namespace xr_examples
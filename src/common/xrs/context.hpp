@@ -2,6 +2,10 @@
 
 #include "common.hpp"
 
+#include <condition_variable>
+#include <exception>
+#include <optional>
+
 #include <openxr/openxr.hpp>
 #include <xrs/debug.hpp>
 
@@ -68,6 +72,8 @@ struct Context {
     xr::InstanceProperties instanceProperties;
     xr::SystemProperties systemProperties;
     bool stopped{ false };
+    // True between xrBeginSession and xrEndSession, i.e. while the application is expected to run the frame loop
+    bool running{ false };
 
     xr::SessionState state{ xr::SessionState::Idle };
     xr::FrameState frameState;
@@ -78,6 +84,28 @@ struct Context {
 
     DebugUtilsEXT::Messenger messenger;
 
+    // When enabled, `xrWaitFrame` is called from a dedicated frame pacing thread, so that the wait for
+    // frame N+1 overlaps the rendering of frame N.  The pacing thread hands each waited `FrameState` to the
+    // render thread as a token.  `xrBeginFrame` and `xrEndFrame` are still called from the render thread.
+    // Must be set before the session reaches the `Ready` state.
+    bool pipelined{ false };
+
+    struct FrameToken {
+        xr::FrameState frameState;
+        uint64_t frameIndex{ 0 };
+    };
+
+    struct FramePacer {
+        using Lock = std::unique_lock<std::mutex>;
+        std::thread thread;
+        std::mutex mutex;
+        std::condition_variable conditional;
+        std::optional<FrameToken> pending;
+        // Why the pacing thread stopped on its own, rethrown on the render thread by `waitFrame()`
+        std::exception_ptr error;
+        bool running{ false };
+    } pacer;
+
     void create() {
         for (const auto& extensionProperties : xr::enumerateInstanceExtensionProperties(nullptr)) {
             discoveredExtensions.insert({ extensionProperties.extensionName, extensionProperties });
@@ -185,6 +213,8 @@ struct Context {
     }
 
     void destroySession() {
+        stopFramePacing();
+        running = false;
         if (session) {
             session.destroy();
             session = nullptr;
@@ -234,11 +264,18 @@ struct Context {
             case xr::SessionState::Ready: {
                 if (!stopped) {
                     session.beginSession(xr::SessionBeginInfo{ requiredViewConfiguration });
+                    running = true;
+                    if (pipelined) {
+                        startFramePacing();
+                    }
                 }
             } break;
 
             case xr::SessionState::Stopping: {
+                // The pacing thread must not be inside xrWaitFrame when the session ends
+                stopFramePacing();
                 session.endSession();
+                running = false;
                 stopped = true;
             } break;
 
@@ -260,29 +297,117 @@ struct Context {
 
     void onInteractionprofileChanged(const xr::EventDataInteractionProfileChanged&) {}
 
+    void startFramePacing() {
+        if (pacer.thread.joinable()) {
+            return;
+        }
+        {
+            FramePacer::Lock lock(pacer.mutex);
+            pacer.pending.reset();
+            pacer.error = nullptr;
+            pacer.running = true;
+        }
+        pacer.thread = std::thread([this] { runFramePacing(); });
+    }
+
+    void stopFramePacing() {
+        if (!pacer.thread.joinable()) {
+            return;
+        }
+        {
+            FramePacer::Lock lock(pacer.mutex);
+            pacer.running = false;
+        }
+        pacer.conditional.notify_all();
+        pacer.thread.join();
+        pacer.pending.reset();
+    }
+
+    void runFramePacing() {
+        uint64_t frameIndex = 0;
+        while (true) {
+            // Only wait on the next frame once the render thread has taken the previous token.  The render
+            // thread calls xrBeginFrame immediately after taking a token, so the xrWaitFrame below is never
+            // left waiting on a frame that will not be begun.
+            {
+                FramePacer::Lock lock(pacer.mutex);
+                pacer.conditional.wait(lock, [&] { return !pacer.running || !pacer.pending.has_value(); });
+                if (!pacer.running) {
+                    break;
+                }
+            }
+
+            FrameToken token;
+            token.frameIndex = ++frameIndex;
+            try {
+                session.waitFrame(xr::FrameWaitInfo{}, token.frameState);
+            } catch (const std::exception& e) {
+                LOG_ERROR("Frame pacing thread failed to wait on frame: {}", e.what());
+                FramePacer::Lock lock(pacer.mutex);
+                pacer.error = std::current_exception();
+                pacer.running = false;
+                pacer.conditional.notify_all();
+                break;
+            }
+
+            {
+                FramePacer::Lock lock(pacer.mutex);
+                pacer.pending = token;
+            }
+            pacer.conditional.notify_all();
+        }
+    }
+
+    // Returns false if no frame could be waited on, in which case the frame must be discarded.  Rethrows the failure of
+    // the pacing thread, which is then joined, so that later frames wait on the render thread
+    bool waitFrame() {
+        if (!pacer.thread.joinable()) {
+            session.waitFrame(xr::FrameWaitInfo{}, frameState);
+            return true;
+        }
+
+        std::optional<FrameToken> token;
+        std::exception_ptr error;
+        {
+            FramePacer::Lock lock(pacer.mutex);
+            pacer.conditional.wait(lock, [&] { return !pacer.running || pacer.pending.has_value(); });
+            std::swap(token, pacer.pending);
+            if (!token.has_value()) {
+                std::swap(error, pacer.error);
+            }
+        }
+        if (error) {
+            pacer.thread.join();
+            std::rethrow_exception(error);
+        }
+        if (!token.has_value()) {
+            return false;
+        }
+        pacer.conditional.notify_all();
+        frameState = token->frameState;
+        return true;
+    }
+
+    void beginFrame() { beginFrameResult = session.beginFrame(xr::FrameBeginInfo{}); }
+
     void onFrameStart() {
         beginFrameResult = xr::Result::FrameDiscarded;
         switch (state) {
             case xr::SessionState::Focused:
             case xr::SessionState::Synchronized:
             case xr::SessionState::Visible: {
-                session.waitFrame(xr::FrameWaitInfo{}, frameState);
-                beginFrameResult = session.beginFrame(xr::FrameBeginInfo{});
-                switch (beginFrameResult) {
-                    case xr::Result::FrameDiscarded:
-                    case xr::Result::SessionLossPending:
-                        return;
-
-                    default:
-                        break;
+                if (waitFrame()) {
+                    beginFrame();
                 }
             } break;
 
             default:
-                beginFrameResult = xr::Result::FrameDiscarded;
+                break;
         }
     }
 
+    bool isSessionRunning() const { return running; }
+
     bool shouldRender() const { return beginFrameResult == xr::Result::Success && frameState.shouldRender; }
 
     xr::BilateralPaths makeHandSubpaths(const std::string& subpath = "") {
@@ -11,7 +11,6 @@ void xrs::gl::FramebufferSwapchain::bindDefault(Target target) {
 }
 
 void xrs::gl::FramebufferSwapchain::createFramebuffer() {
-    glCreateFramebuffers(1, &fbo);
     glCreateRenderbuffers(1, &depthStencil);
     glBindRenderbuffer(GL_RENDERBUFFER, depthStencil);
     if (createInfo.sampleCount == 1) {
@@ -19,12 +18,23 @@ void xrs::gl::FramebufferSwapchain::createFramebuffer() {
     } else {
         glNamedRenderbufferStorageMultisample(depthStencil, createInfo.sampleCount, GL_DEPTH24_STENCIL8, createInfo.width, createInfo.height);
     }
-    glNamedFramebufferRenderbuffer(fbo, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthStencil);
+    fbos.resize(images.size());
+    glCreateFramebuffers((GLsizei)fbos.size(), fbos.data());
+    for (size_t i = 0; i < fbos.size(); ++i) {
+        glNamedFramebufferTexture(fbos[i], GL_COLOR_ATTACHMENT0, images[i].image, 0);
+        glNamedFramebufferRenderbuffer(fbos[i], GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthStencil);
+        if (glCheckNamedFramebufferStatus(fbos[i], GL_DRAW_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            throw std::runtime_error("Swapchain framebuffer incomplete");
+        }
+    }
 }
 
 
 void xrs::gl::FramebufferSwapchain::destroyFramebuffer() {
-    glDeleteFramebuffers(1, &fbo);
+    if (!fbos.empty()) {
+        glDeleteFramebuffers((GLsizei)fbos.size(), fbos.data());
+        fbos.clear();
+    }
     fbo = 0;
 
     glDeleteRenderbuffers(1, &depthStencil);
@@ -43,12 +53,11 @@ void xrs::gl::FramebufferSwapchain::destroy() {
 
 ::xr::SwapchainImageOpenGLKHR& xrs::gl::FramebufferSwapchain::acquireImage() {
     auto& result = Parent::acquireImage();
-    glNamedFramebufferTexture(fbo, GL_COLOR_ATTACHMENT0, result.image, 0);
+    fbo = fbos[currentIndex];
     return result;
 }
 
 void xrs::gl::FramebufferSwapchain::releaseImage() {
-    glNamedFramebufferTexture(fbo, GL_COLOR_ATTACHMENT0, 0, 0);
     Parent::releaseImage();
 }
 
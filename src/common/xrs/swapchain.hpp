@@ -2,6 +2,10 @@
 
 #define XR_USE_GRAPHICS_API_OPENGL
 
+#include <algorithm>
+#include <array>
+#include <vector>
+
 #include <openxr/openxr.hpp>
 
 namespace xrs {
@@ -10,7 +14,18 @@ namespace xrs {
 using DefaultSwapchainImageType = xr::SwapchainImageVulkanKHR;
 using SwapchainFormatType = vk::Format;
 constexpr vk::Format DEFAULT_SWAPCHAIN_FORMAT{ vk::Format::eB8G8R8A8Srgb };
-constexpr vk::Format DEFAULT_SWAPCHAIN_DEPTH_FORMAT{ vk::Format::eB8G8R8A8Srgb };
+constexpr vk::Format DEFAULT_SWAPCHAIN_DEPTH_FORMAT{ vk::Format::eD24UnormS8Uint };
+// Depth formats in order of preference, those with a stencil component first
+constexpr std::array<vk::Format, 4> DEPTH_SWAPCHAIN_FORMATS{
+    vk::Format::eD24UnormS8Uint,
+    vk::Format::eD32SfloatS8Uint,
+    vk::Format::eD32Sfloat,
+    vk::Format::eD16Unorm,
+};
+
+inline bool hasStencil(vk::Format format) {
+    return format == vk::Format::eD24UnormS8Uint || format == vk::Format::eD32SfloatS8Uint;
+}
 #elif defined(XR_USE_GRAPHICS_API_OPENGL)
 using DefaultSwapchainImageType = xr::SwapchainImageOpenGLKHR;
 using SwapchainFormatType = uint32_t;
@@ -18,8 +33,32 @@ using SwapchainFormatType = uint32_t;
 constexpr uint32_t DEFAULT_SWAPCHAIN_FORMAT{ 0x8C43 };
 // GL_DEPTH24_STENCIL8
 constexpr uint32_t DEFAULT_SWAPCHAIN_DEPTH_FORMAT{ 0x88F0 };
+// Depth formats in order of preference, those with a stencil component first
+constexpr std::array<uint32_t, 5> DEPTH_SWAPCHAIN_FORMATS{
+    0x88F0,  // GL_DEPTH24_STENCIL8
+    0x8CAD,  // GL_DEPTH32F_STENCIL8
+    0x8CAC,  // GL_DEPTH_COMPONENT32F
+    0x81A6,  // GL_DEPTH_COMPONENT24
+    0x81A5,  // GL_DEPTH_COMPONENT16
+};
+
+inline bool hasStencil(uint32_t format) {
+    return format == 0x88F0 || format == 0x8CAD;
+}
 #endif
 
+// Picks the most preferred of `DEPTH_SWAPCHAIN_FORMATS` that the runtime supports, as reported by
+// `xr::Session::enumerateSwapchainFormats`.  Returns false if it supports none of them.
+inline bool selectDepthSwapchainFormat(const std::vector<int64_t>& runtimeFormats, SwapchainFormatType& format) {
+    for (const auto& candidate : DEPTH_SWAPCHAIN_FORMATS) {
+        if (std::find(runtimeFormats.begin(), runtimeFormats.end(), (int64_t)candidate) != runtimeFormats.end()) {
+            format = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
 template <typename SwapchainImageType = DefaultSwapchainImageType>
 struct Swapchain {
     static constexpr uint32_t INVALID_SWAPCHAIN_INDEX = (uint32_t)-1;
@@ -110,7 +149,11 @@ public:
     void createFramebuffer();
     void destroyFramebuffer();
 
+    // The FBO of the acquired image, one of `fbos`
     uint32_t fbo{ 0 };
+    // One complete FBO per swapchain image, all sharing the depth buffer, so acquiring an image doesn't change any
+    // framebuffer attachments
+    std::vector<uint32_t> fbos;
     uint32_t depthStencil{ 0 };
 };
 
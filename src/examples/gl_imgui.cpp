@@ -223,9 +223,12 @@ class OpenXrExample : public ExampleType {
     } ui;
 
 public:
+    // The scene is only a skybox, which renders both eyes at once via multiview where it's supported
+    OpenXrExample() { multiviewRendering = true; }
     ~OpenXrExample() {}
 
-    void uiHandler() {
+    // Runs on the UI rendering thread, so it only reads the state snapshotted in the request
+    void uiHandler(const imgui::Renderer::FrameRequest& request) {
         ImGuiIO& io{ ImGui::GetIO() };
         io.DisplaySize = ImVec2((float)UI_SIZE.width, (float)UI_SIZE.height);
         ImGui::NewFrame();
@@ -244,8 +247,9 @@ public:
             ImGui::Checkbox("Demo Window", &show_demo_window);  // Edit bools storing our window open/close state
             ImGui::Checkbox("Another Window", &show_another_window);
 
-            ImGui::InputFloat3("Pos", &handStates[0].aim.position.x, ImGuiInputTextFlags_ReadOnly);
-            ImGui::InputFloat4("Rot", &handStates[0].aim.orientation.x, ImGuiInputTextFlags_ReadOnly);
+            auto aim = request.handStates[0].aim;
+            ImGui::InputFloat3("Pos", &aim.position.x, ImGuiInputTextFlags_ReadOnly);
+            ImGui::InputFloat4("Rot", &aim.orientation.x, ImGuiInputTextFlags_ReadOnly);
             if (ImGui::Button("Button"))
                 counter++;
             ImGui::SameLine();
@@ -260,8 +264,8 @@ public:
 
     void prepareUi() {
         imgui::Renderer::init();
-        ui.renderer.setHandler([this] { uiHandler(); });
-        ui.renderer.create(UI_SIZE, xrSession, window);
+        ui.renderer.setHandler([this](const imgui::Renderer::FrameRequest& request) { uiHandler(request); });
+        ui.renderer.create(UI_SIZE, xrSession, renderWorkers);
         ui.layer.space = space;
         ui.layer.subImage.swapchain = ui.renderer.getSwapchain();
         ui.layer.subImage.imageRect = { { 0, 0 }, UI_SIZE };
@@ -277,7 +281,7 @@ public:
 
     void renderExtraLayers() override {
         ui.layer.pose.position = handStates[0].aim.position;
-        ui.renderer.requestNewFrame();
+        ui.renderer.requestNewFrame(xrContext.frameState.predictedDisplayTime, eyeStates, handStates);
     }
 
     std::string getWindowTitle() {
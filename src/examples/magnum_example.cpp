@@ -25,7 +25,8 @@ class OpenXrExample : public ExampleType {
         xr::CompositionLayerQuad layer;
     } ui;
 
-    void uiHandler() {
+    // Runs on the UI rendering thread, so it only reads the state snapshotted in the request
+    void uiHandler(const imgui::Renderer::FrameRequest& request) {
         ImGuiIO& io{ ImGui::GetIO() };
         io.DisplaySize = ImVec2((float)UI_SIZE.width, (float)UI_SIZE.height);
         ImGui::NewFrame();
@@ -44,8 +45,9 @@ class OpenXrExample : public ExampleType {
             ImGui::Checkbox("Demo Window", &show_demo_window);  // Edit bools storing our window open/close state
             ImGui::Checkbox("Another Window", &show_another_window);
 
-            ImGui::InputFloat3("Pos", &handStates[0].aim.position.x, ImGuiInputTextFlags_ReadOnly);
-            ImGui::InputFloat4("Rot", &handStates[0].aim.orientation.x, ImGuiInputTextFlags_ReadOnly);
+            auto aim = request.handStates[0].aim;
+            ImGui::InputFloat3("Pos", &aim.position.x, ImGuiInputTextFlags_ReadOnly);
+            ImGui::InputFloat4("Rot", &aim.orientation.x, ImGuiInputTextFlags_ReadOnly);
             if (ImGui::Button("Button"))
                 counter++;
             ImGui::SameLine();
@@ -60,8 +62,8 @@ class OpenXrExample : public ExampleType {
 
     void prepareUi() {
         imgui::Renderer::init();
-        ui.renderer.setHandler([this] { uiHandler(); });
-        ui.renderer.create(UI_SIZE, xrSession, window);
+        ui.renderer.setHandler([this](const imgui::Renderer::FrameRequest& request) { uiHandler(request); });
+        ui.renderer.create(UI_SIZE, xrSession, renderWorkers);
         ui.layer.space = space;
         ui.layer.subImage.swapchain = ui.renderer.getSwapchain();
         ui.layer.subImage.imageRect = { { 0, 0 }, UI_SIZE };
@@ -77,7 +79,7 @@ class OpenXrExample : public ExampleType {
 
     void renderExtraLayers() override {
         ui.layer.pose.position = handStates[0].aim.position;
-        ui.renderer.requestNewFrame();
+        ui.renderer.requestNewFrame(xrContext.frameState.predictedDisplayTime, eyeStates, handStates);
     }
 };
 
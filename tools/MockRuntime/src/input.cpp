@@ -0,0 +1,241 @@
+//
+//  Created by Bradley Austin Davis
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#include "runtime.hpp"
+
+#include <cmath>
+
+namespace mock {
+
+//
+// Paths
+//
+
+XRAPI_ATTR XrResult XRAPI_CALL xrStringToPath(XrInstance instance, const char* pathString, XrPath* path) {
+    if (nullptr == pathString || pathString[0] != '/') {
+        return XR_ERROR_PATH_FORMAT_INVALID;
+    }
+    *path = getPath(pathString);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL
+xrPathToString(XrInstance instance, XrPath path, uint32_t bufferCapacityInput, uint32_t* bufferCountOutput, char* buffer) {
+    const auto& pathString = getPathString(path);
+    if (pathString.empty()) {
+        return XR_ERROR_PATH_INVALID;
+    }
+    *bufferCountOutput = (uint32_t)pathString.size() + 1;
+    if (0 == bufferCapacityInput) {
+        return XR_SUCCESS;
+    }
+    if (bufferCapacityInput < *bufferCountOutput) {
+        return XR_ERROR_SIZE_INSUFFICIENT;
+    }
+    memcpy(buffer, pathString.c_str(), *bufferCountOutput);
+    return XR_SUCCESS;
+}
+
+//
+// Actions
+//
+
+XRAPI_ATTR XrResult XRAPI_CALL xrCreateActionSet(XrInstance instance,
+                                                 const XrActionSetCreateInfo* createInfo,
+                                                 XrActionSet* actionSet) {
+    auto target = new ActionSet();
+    target->name = createInfo->actionSetName;
+    *actionSet = toHandle<XrActionSet>(target);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrDestroyActionSet(XrActionSet actionSet) {
+    delete fromHandle<ActionSet>(actionSet);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrCreateAction(XrActionSet actionSet, const XrActionCreateInfo* createInfo, XrAction* action) {
+    if (fromHandle<ActionSet>(actionSet)->attached) {
+        return XR_ERROR_ACTIONSETS_ALREADY_ATTACHED;
+    }
+    auto target = new Action();
+    target->actionSet = actionSet;
+    target->type = createInfo->actionType;
+    target->name = createInfo->actionName;
+    *action = toHandle<XrAction>(target);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrDestroyAction(XrAction action) {
+    delete fromHandle<Action>(action);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrSuggestInteractionProfileBindings(XrInstance instance,
+                                                                     const XrInteractionProfileSuggestedBinding* suggestedBindings) {
+    // Every suggested profile is accepted, the fake controllers produce data for any action regardless of binding
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrAttachSessionActionSets(XrSession session, const XrSessionActionSetsAttachInfo* attachInfo) {
+    for (uint32_t i = 0; i < attachInfo->countActionSets; ++i) {
+        auto actionSet = fromHandle<ActionSet>(attachInfo->actionSets[i]);
+        if (actionSet->attached) {
+            return XR_ERROR_ACTIONSETS_ALREADY_ATTACHED;
+        }
+        actionSet->attached = true;
+    }
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrGetCurrentInteractionProfile(XrSession session,
+                                                              XrPath topLevelUserPath,
+                                                              XrInteractionProfileState* interactionProfile) {
+    interactionProfile->interactionProfile = getPath("/interaction_profiles/khr/simple_controller");
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrSyncActions(XrSession session, const XrActionsSyncInfo* syncInfo) {
+    auto target = fromHandle<Session>(session);
+    if (target->state != XR_SESSION_STATE_FOCUSED) {
+        return XR_SESSION_NOT_FOCUSED;
+    }
+    return XR_SUCCESS;
+}
+
+// Analog values sweep through their whole range over a few seconds, on the same clock the frames are predicted on
+static float getAnalogValue(const XrActionStateGetInfo* getInfo, double phase) {
+    static const XrPath LEFT_HAND = getPath("/user/hand/left");
+    auto seconds = toSeconds(now()) + (getInfo->subactionPath == LEFT_HAND ? 0.0 : 1.0);
+    return (float)(0.5 + 0.5 * sin(seconds + phase));
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrGetActionStateBoolean(XrSession session,
+                                                       const XrActionStateGetInfo* getInfo,
+                                                       XrActionStateBoolean* state) {
+    state->currentState = XR_FALSE;
+    state->changedSinceLastSync = XR_FALSE;
+    state->lastChangeTime = 0;
+    state->isActive = XR_TRUE;
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrGetActionStateFloat(XrSession session,
+                                                     const XrActionStateGetInfo* getInfo,
+                                                     XrActionStateFloat* state) {
+    state->currentState = getAnalogValue(getInfo, 0.0);
+    state->changedSinceLastSync = XR_TRUE;
+    state->lastChangeTime = now();
+    state->isActive = XR_TRUE;
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrGetActionStateVector2f(XrSession session,
+                                                        const XrActionStateGetInfo* getInfo,
+                                                        XrActionStateVector2f* state) {
+    state->currentState = { getAnalogValue(getInfo, 0.0) * 2.0f - 1.0f, getAnalogValue(getInfo, 1.57) * 2.0f - 1.0f };
+    state->changedSinceLastSync = XR_TRUE;
+    state->lastChangeTime = now();
+    state->isActive = XR_TRUE;
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrGetActionStatePose(XrSession session,
+                                                    const XrActionStateGetInfo* getInfo,
+                                                    XrActionStatePose* state) {
+    state->isActive = XR_TRUE;
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrApplyHapticFeedback(XrSession session,
+                                                     const XrHapticActionInfo* hapticActionInfo,
+                                                     const XrHapticBaseHeader* hapticFeedback) {
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrStopHapticFeedback(XrSession session, const XrHapticActionInfo* hapticActionInfo) {
+    return XR_SUCCESS;
+}
+
+//
+// Spaces
+//
+
+XRAPI_ATTR XrResult XRAPI_CALL xrEnumerateReferenceSpaces(XrSession session,
+                                                          uint32_t spaceCapacityInput,
+                                                          uint32_t* spaceCountOutput,
+                                                          XrReferenceSpaceType* spaces) {
+    return fillArray<XrReferenceSpaceType>(spaceCapacityInput, spaceCountOutput, spaces,
+                                           { XR_REFERENCE_SPACE_TYPE_VIEW, XR_REFERENCE_SPACE_TYPE_LOCAL,
+                                             XR_REFERENCE_SPACE_TYPE_STAGE });
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrCreateReferenceSpace(XrSession session,
+                                                      const XrReferenceSpaceCreateInfo* createInfo,
+                                                      XrSpace* space) {
+    auto target = new Space();
+    target->referenceType = createInfo->referenceSpaceType;
+    target->poseInSpace = createInfo->poseInReferenceSpace;
+    *space = toHandle<XrSpace>(target);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrGetReferenceSpaceBoundsRect(XrSession session,
+                                                             XrReferenceSpaceType referenceSpaceType,
+                                                             XrExtent2Df* bounds) {
+    bounds->width = 0.0f;
+    bounds->height = 0.0f;
+    return XR_SPACE_BOUNDS_UNAVAILABLE;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrCreateActionSpace(XrSession session, const XrActionSpaceCreateInfo* createInfo, XrSpace* space) {
+    auto target = new Space();
+    target->action = createInfo->action;
+    target->subactionPath = createInfo->subactionPath;
+    target->poseInSpace = createInfo->poseInActionSpace;
+    *space = toHandle<XrSpace>(target);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrLocateSpace(XrSpace space, XrSpace baseSpace, XrTime time, XrSpaceLocation* location) {
+    auto target = fromHandle<Space>(space);
+    auto base = fromHandle<Space>(baseSpace);
+    location->pose = multiply(invert(getSpacePose(*base, time)), getSpacePose(*target, time));
+    location->locationFlags = XR_SPACE_LOCATION_ORIENTATION_VALID_BIT | XR_SPACE_LOCATION_POSITION_VALID_BIT |
+                              XR_SPACE_LOCATION_ORIENTATION_TRACKED_BIT | XR_SPACE_LOCATION_POSITION_TRACKED_BIT;
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrDestroySpace(XrSpace space) {
+    delete fromHandle<Space>(space);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrLocateViews(XrSession session,
+                                             const XrViewLocateInfo* viewLocateInfo,
+                                             XrViewState* viewState,
+                                             uint32_t viewCapacityInput,
+                                             uint32_t* viewCountOutput,
+                                             XrView* views) {
+    if (viewLocateInfo->viewConfigurationType != XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO) {
+        return XR_ERROR_VIEW_CONFIGURATION_TYPE_UNSUPPORTED;
+    }
+
+    viewState->viewStateFlags = XR_VIEW_STATE_ORIENTATION_VALID_BIT | XR_VIEW_STATE_POSITION_VALID_BIT |
+                                XR_VIEW_STATE_ORIENTATION_TRACKED_BIT | XR_VIEW_STATE_POSITION_TRACKED_BIT;
+
+    auto baseInverse = invert(getSpacePose(*fromHandle<Space>(viewLocateInfo->space), viewLocateInfo->displayTime));
+    std::vector<XrView> result;
+    for (uint32_t eye = 0; eye < 2; ++eye) {
+        XrView view{ XR_TYPE_VIEW };
+        view.pose = multiply(baseInverse, getEyePose(viewLocateInfo->displayTime, eye));
+        view.fov = { -MOCK_FOV_HALF_ANGLE, MOCK_FOV_HALF_ANGLE, MOCK_FOV_HALF_ANGLE, -MOCK_FOV_HALF_ANGLE };
+        result.push_back(view);
+    }
+    return fillArray(viewCapacityInput, viewCountOutput, views, result);
+}
+
+}  // namespace mock
@@ -0,0 +1,610 @@
+//
+//  Created by Bradley Austin Davis
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#include "runtime.hpp"
+#include "loaderInterfaces.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+#if defined(_WIN32)
+#define MOCK_RUNTIME_EXPORT extern "C" __declspec(dllexport)
+#else
+#define MOCK_RUNTIME_EXPORT extern "C" __attribute__((visibility("default")))
+#endif
+
+namespace mock {
+
+Instance* g_instance{ nullptr };
+
+static const std::vector<XrExtensionProperties>& getExtensions() {
+    static std::vector<XrExtensionProperties> extensions;
+    if (extensions.empty()) {
+        XrExtensionProperties properties{ XR_TYPE_EXTENSION_PROPERTIES };
+        strcpy(properties.extensionName, XR_KHR_OPENGL_ENABLE_EXTENSION_NAME);
+        properties.extensionVersion = XR_KHR_opengl_enable_SPEC_VERSION;
+        extensions.push_back(properties);
+        strcpy(properties.extensionName, XR_KHR_COMPOSITION_LAYER_DEPTH_EXTENSION_NAME);
+        properties.extensionVersion = XR_KHR_composition_layer_depth_SPEC_VERSION;
+        extensions.push_back(properties);
+    }
+    return extensions;
+}
+
+static const XrSystemId MOCK_SYSTEM_ID{ 1 };
+static const float MOCK_IPD{ 0.064f };
+
+template <typename T>
+static T getEnvironmentValue(const char* name, T defaultValue) {
+    auto value = getenv(name);
+    if (!value) {
+        return defaultValue;
+    }
+    return (T)atof(value);
+}
+
+Config Config::fromEnvironment() {
+    Config config;
+    config.imageWidth = getEnvironmentValue<uint32_t>("XR_MOCK_IMAGE_WIDTH", config.imageWidth);
+    config.imageHeight = getEnvironmentValue<uint32_t>("XR_MOCK_IMAGE_HEIGHT", config.imageHeight);
+    config.displayHz = getEnvironmentValue<double>("XR_MOCK_DISPLAY_HZ", config.displayHz);
+    config.swapchainLength = getEnvironmentValue<uint32_t>("XR_MOCK_SWAPCHAIN_LENGTH", config.swapchainLength);
+    return config;
+}
+
+XrTime now() {
+    static const auto epoch = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count() + 1;
+}
+
+void Instance::queueSessionState(XrSessionState state) {
+    XrEventDataBuffer buffer{ XR_TYPE_EVENT_DATA_BUFFER };
+    auto& event = reinterpret_cast<XrEventDataSessionStateChanged&>(buffer);
+    event.type = XR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED;
+    event.next = nullptr;
+    event.session = toHandle<XrSession>(session);
+    event.state = state;
+    event.time = now();
+    std::unique_lock<std::mutex> lock(mutex);
+    events.push_back(buffer);
+}
+
+//
+// Pose math
+//
+
+static XrQuaternionf multiply(const XrQuaternionf& a, const XrQuaternionf& b) {
+    return { a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,  //
+             a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,  //
+             a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,  //
+             a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z };
+}
+
+static XrVector3f rotate(const XrQuaternionf& q, const XrVector3f& v) {
+    XrQuaternionf p{ v.x, v.y, v.z, 0.0f };
+    XrQuaternionf conjugate{ -q.x, -q.y, -q.z, q.w };
+    auto result = multiply(multiply(q, p), conjugate);
+    return { result.x, result.y, result.z };
+}
+
+XrPosef multiply(const XrPosef& a, const XrPosef& b) {
+    XrPosef result;
+    result.orientation = multiply(a.orientation, b.orientation);
+    auto offset = rotate(a.orientation, b.position);
+    result.position = { a.position.x + offset.x, a.position.y + offset.y, a.position.z + offset.z };
+    return result;
+}
+
+XrPosef invert(const XrPosef& pose) {
+    XrPosef result;
+    result.orientation = { -pose.orientation.x, -pose.orientation.y, -pose.orientation.z, pose.orientation.w };
+    auto position = rotate(result.orientation, pose.position);
+    result.position = { -position.x, -position.y, -position.z };
+    return result;
+}
+
+// The head slowly looks left and right, and bobs a little, so that the rendered view changes every frame
+XrPosef getHeadPose(XrTime time) {
+    auto seconds = toSeconds(time);
+    auto yaw = (float)(0.4 * sin(seconds * 0.5));
+    XrPosef result;
+    result.orientation = { 0.0f, sinf(yaw / 2.0f), 0.0f, cosf(yaw / 2.0f) };
+    result.position = { 0.0f, (float)(0.02 * sin(seconds * 2.0)), 0.0f };
+    return result;
+}
+
+XrPosef getEyePose(XrTime time, uint32_t eye) {
+    XrPosef eyeOffset{ { 0, 0, 0, 1 }, { (eye == 0 ? -0.5f : 0.5f) * MOCK_IPD, 0.0f, 0.0f } };
+    return multiply(getHeadPose(time), eyeOffset);
+}
+
+XrPosef getHandPose(XrTime time, XrPath subactionPath) {
+    static const XrPath LEFT_HAND = getPath("/user/hand/left");
+    auto seconds = toSeconds(time);
+    float side = (subactionPath == LEFT_HAND) ? -1.0f : 1.0f;
+    XrPosef result{ { 0, 0, 0, 1 }, { 0, 0, 0 } };
+    result.position = { side * 0.2f + (float)(0.05 * cos(seconds)), -0.3f + (float)(0.05 * sin(seconds)), -0.4f };
+    return result;
+}
+
+XrPosef getSpacePose(const Space& space, XrTime time) {
+    XrPosef base{ { 0, 0, 0, 1 }, { 0, 0, 0 } };
+    if (space.action != XR_NULL_HANDLE) {
+        base = getHandPose(time, space.subactionPath);
+    } else if (space.referenceType == XR_REFERENCE_SPACE_TYPE_VIEW) {
+        base = getHeadPose(time);
+    } else if (space.referenceType == XR_REFERENCE_SPACE_TYPE_STAGE) {
+        base.position.y = -1.6f;
+    }
+    return multiply(base, space.poseInSpace);
+}
+
+static std::mutex pathMutex;
+static std::unordered_map<std::string, XrPath> pathIds;
+static std::deque<std::string> paths;
+
+XrPath getPath(const std::string& path) {
+    std::unique_lock<std::mutex> lock(pathMutex);
+    auto itr = pathIds.find(path);
+    if (itr != pathIds.end()) {
+        return itr->second;
+    }
+    paths.push_back(path);
+    XrPath result = (XrPath)paths.size();
+    pathIds.insert({ path, result });
+    return result;
+}
+
+const std::string& getPathString(XrPath path) {
+    static const std::string EMPTY;
+    std::unique_lock<std::mutex> lock(pathMutex);
+    if (path == XR_NULL_PATH || path > paths.size()) {
+        return EMPTY;
+    }
+    // Elements of a deque are never moved by push_back, so the reference stays valid after unlocking
+    return paths[path - 1];
+}
+
+//
+// Instance
+//
+
+static XRAPI_ATTR XrResult XRAPI_CALL xrEnumerateInstanceExtensionProperties(const char* layerName,
+                                                                             uint32_t propertyCapacityInput,
+                                                                             uint32_t* propertyCountOutput,
+                                                                             XrExtensionProperties* properties) {
+    if (nullptr != layerName) {
+        return XR_ERROR_API_LAYER_NOT_PRESENT;
+    }
+    return fillArray(propertyCapacityInput, propertyCountOutput, properties, getExtensions());
+}
+
+// The runtime has no layers of its own
+static XRAPI_ATTR XrResult XRAPI_CALL xrEnumerateApiLayerProperties(uint32_t propertyCapacityInput,
+                                                                    uint32_t* propertyCountOutput,
+                                                                    XrApiLayerProperties* properties) {
+    return fillArray<XrApiLayerProperties>(propertyCapacityInput, propertyCountOutput, properties, {});
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL xrCreateInstance(const XrInstanceCreateInfo* createInfo, XrInstance* instance) {
+    if (nullptr == createInfo || nullptr == instance) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    if (nullptr != g_instance) {
+        return XR_ERROR_LIMIT_REACHED;
+    }
+
+    for (uint32_t i = 0; i < createInfo->enabledExtensionCount; ++i) {
+        const auto& extensions = getExtensions();
+        auto itr = std::find_if(extensions.begin(), extensions.end(), [&](const XrExtensionProperties& properties) {
+            return 0 == strcmp(properties.extensionName, createInfo->enabledExtensionNames[i]);
+        });
+        if (itr == extensions.end()) {
+            return XR_ERROR_EXTENSION_NOT_PRESENT;
+        }
+    }
+
+    g_instance = new Instance();
+    g_instance->config = Config::fromEnvironment();
+    *instance = toHandle<XrInstance>(g_instance);
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL xrDestroyInstance(XrInstance instance) {
+    auto target = fromHandle<Instance>(instance);
+    if (target != g_instance) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    delete g_instance;
+    g_instance = nullptr;
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL xrGetInstanceProperties(XrInstance instance, XrInstanceProperties* properties) {
+    properties->runtimeVersion = XR_MAKE_VERSION(0, 1, 0);
+    strcpy(properties->runtimeName, "OpenXR Examples Mock Runtime");
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL xrPollEvent(XrInstance instance, XrEventDataBuffer* eventData) {
+    std::unique_lock<std::mutex> lock(g_instance->mutex);
+    if (g_instance->events.empty()) {
+        return XR_EVENT_UNAVAILABLE;
+    }
+    *eventData = g_instance->events.front();
+    g_instance->events.pop_front();
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL xrResultToString(XrInstance instance,
+                                                       XrResult value,
+                                                       char buffer[XR_MAX_RESULT_STRING_SIZE]) {
+    snprintf(buffer, XR_MAX_RESULT_STRING_SIZE, "XR_RESULT_%d", (int)value);
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL xrStructureTypeToString(XrInstance instance,
+                                                              XrStructureType value,
+                                                              char buffer[XR_MAX_STRUCTURE_NAME_SIZE]) {
+    snprintf(buffer, XR_MAX_STRUCTURE_NAME_SIZE, "XR_STRUCTURE_TYPE_%d", (int)value);
+    return XR_SUCCESS;
+}
+
+//
+// System
+//
+
+static XRAPI_ATTR XrResult XRAPI_CALL xrGetSystem(XrInstance instance, const XrSystemGetInfo* getInfo, XrSystemId* systemId) {
+    if (getInfo->formFactor != XR_FORM_FACTOR_HEAD_MOUNTED_DISPLAY) {
+        return XR_ERROR_FORM_FACTOR_UNSUPPORTED;
+    }
+    *systemId = MOCK_SYSTEM_ID;
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL xrGetSystemProperties(XrInstance instance,
+                                                            XrSystemId systemId,
+                                                            XrSystemProperties* properties) {
+    if (systemId != MOCK_SYSTEM_ID) {
+        return XR_ERROR_SYSTEM_INVALID;
+    }
+    const auto& config = g_instance->config;
+    properties->systemId = MOCK_SYSTEM_ID;
+    properties->vendorId = 0;
+    strcpy(properties->systemName, "Mock HMD");
+    properties->graphicsProperties.maxLayerCount = XR_MIN_COMPOSITION_LAYERS_SUPPORTED;
+    properties->graphicsProperties.maxSwapchainImageWidth = config.imageWidth * 2;
+    properties->graphicsProperties.maxSwapchainImageHeight = config.imageHeight * 2;
+    properties->trackingProperties.orientationTracking = XR_TRUE;
+    properties->trackingProperties.positionTracking = XR_TRUE;
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL xrEnumerateEnvironmentBlendModes(XrInstance instance,
+                                                                       XrSystemId systemId,
+                                                                       XrViewConfigurationType viewConfigurationType,
+                                                                       uint32_t environmentBlendModeCapacityInput,
+                                                                       uint32_t* environmentBlendModeCountOutput,
+                                                                       XrEnvironmentBlendMode* environmentBlendModes) {
+    return fillArray<XrEnvironmentBlendMode>(environmentBlendModeCapacityInput, environmentBlendModeCountOutput,
+                                             environmentBlendModes, { XR_ENVIRONMENT_BLEND_MODE_OPAQUE });
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL xrEnumerateViewConfigurations(XrInstance instance,
+                                                                    XrSystemId systemId,
+                                                                    uint32_t viewConfigurationTypeCapacityInput,
+                                                                    uint32_t* viewConfigurationTypeCountOutput,
+                                                                    XrViewConfigurationType* viewConfigurationTypes) {
+    return fillArray<XrViewConfigurationType>(viewConfigurationTypeCapacityInput, viewConfigurationTypeCountOutput,
+                                              viewConfigurationTypes, { XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO });
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL xrGetViewConfigurationProperties(XrInstance instance,
+                                                                       XrSystemId systemId,
+                                                                       XrViewConfigurationType viewConfigurationType,
+                                                                       XrViewConfigurationProperties* configurationProperties) {
+    if (viewConfigurationType != XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO) {
+        return XR_ERROR_VIEW_CONFIGURATION_TYPE_UNSUPPORTED;
+    }
+    configurationProperties->viewConfigurationType = viewConfigurationType;
+    configurationProperties->fovMutable = XR_FALSE;
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL xrEnumerateViewConfigurationViews(XrInstance instance,
+                                                                        XrSystemId systemId,
+                                                                        XrViewConfigurationType viewConfigurationType,
+                                                                        uint32_t viewCapacityInput,
+                                                                        uint32_t* viewCountOutput,
+                                                                        XrViewConfigurationView* views) {
+    if (viewConfigurationType != XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO) {
+        return XR_ERROR_VIEW_CONFIGURATION_TYPE_UNSUPPORTED;
+    }
+    const auto& config = g_instance->config;
+    XrViewConfigurationView view{ XR_TYPE_VIEW_CONFIGURATION_VIEW };
+    view.recommendedImageRectWidth = config.imageWidth;
+    view.recommendedImageRectHeight = config.imageHeight;
+    view.maxImageRectWidth = config.imageWidth * 2;
+    view.maxImageRectHeight = config.imageHeight * 2;
+    view.recommendedSwapchainSampleCount = 1;
+    view.maxSwapchainSampleCount = 1;
+    return fillArray<XrViewConfigurationView>(viewCapacityInput, viewCountOutput, views, { view, view });
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL
+xrGetOpenGLGraphicsRequirementsKHR(XrInstance instance,
+                                   XrSystemId systemId,
+                                   XrGraphicsRequirementsOpenGLKHR* graphicsRequirements) {
+    graphicsRequirements->minApiVersionSupported = XR_MAKE_VERSION(4, 5, 0);
+    graphicsRequirements->maxApiVersionSupported = XR_MAKE_VERSION(4, 6, 0);
+    return XR_SUCCESS;
+}
+
+//
+// Session
+//
+
+static XRAPI_ATTR XrResult XRAPI_CALL xrCreateSession(XrInstance instance,
+                                                      const XrSessionCreateInfo* createInfo,
+                                                      XrSession* session) {
+    if (createInfo->systemId != MOCK_SYSTEM_ID) {
+        return XR_ERROR_SYSTEM_INVALID;
+    }
+    if (nullptr != g_instance->session) {
+        return XR_ERROR_LIMIT_REACHED;
+    }
+
+    // Whatever the platform binding is, the application's GL context is current on this thread
+    if (!gladLoadGL()) {
+        return XR_ERROR_GRAPHICS_DEVICE_INVALID;
+    }
+
+    g_instance->session = new Session();
+    *session = toHandle<XrSession>(g_instance->session);
+    g_instance->queueSessionState(XR_SESSION_STATE_IDLE);
+    g_instance->queueSessionState(XR_SESSION_STATE_READY);
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL xrDestroySession(XrSession session) {
+    auto target = fromHandle<Session>(session);
+    if (target != g_instance->session) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    delete target;
+    g_instance->session = nullptr;
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL xrBeginSession(XrSession session, const XrSessionBeginInfo* beginInfo) {
+    auto target = fromHandle<Session>(session);
+    if (target->running) {
+        return XR_ERROR_SESSION_RUNNING;
+    }
+    target->running = true;
+    g_instance->queueSessionState(XR_SESSION_STATE_SYNCHRONIZED);
+    g_instance->queueSessionState(XR_SESSION_STATE_VISIBLE);
+    g_instance->queueSessionState(XR_SESSION_STATE_FOCUSED);
+    target->state = XR_SESSION_STATE_FOCUSED;
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL xrEndSession(XrSession session) {
+    auto target = fromHandle<Session>(session);
+    if (!target->running) {
+        return XR_ERROR_SESSION_NOT_RUNNING;
+    }
+    {
+        std::unique_lock<std::mutex> lock(target->frameMutex);
+        target->running = false;
+    }
+    target->frameConditional.notify_all();
+    target->state = XR_SESSION_STATE_IDLE;
+    g_instance->queueSessionState(XR_SESSION_STATE_IDLE);
+    if (target->exitRequested) {
+        g_instance->queueSessionState(XR_SESSION_STATE_EXITING);
+    }
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL xrRequestExitSession(XrSession session) {
+    auto target = fromHandle<Session>(session);
+    if (!target->running) {
+        return XR_ERROR_SESSION_NOT_RUNNING;
+    }
+    target->exitRequested = true;
+    target->state = XR_SESSION_STATE_STOPPING;
+    g_instance->queueSessionState(XR_SESSION_STATE_VISIBLE);
+    g_instance->queueSessionState(XR_SESSION_STATE_SYNCHRONIZED);
+    g_instance->queueSessionState(XR_SESSION_STATE_STOPPING);
+    return XR_SUCCESS;
+}
+
+//
+// Frame loop
+//
+
+static XRAPI_ATTR XrResult XRAPI_CALL xrWaitFrame(XrSession session,
+                                                  const XrFrameWaitInfo* frameWaitInfo,
+                                                  XrFrameState* frameState) {
+    auto target = fromHandle<Session>(session);
+    {
+        std::unique_lock<std::mutex> lock(target->frameMutex);
+        // Block until the previously waited frame has been begun
+        target->frameConditional.wait(lock, [&] { return !target->running || target->begunFrames >= target->waitedFrames; });
+        if (!target->running) {
+            return XR_ERROR_SESSION_NOT_RUNNING;
+        }
+    }
+
+    // Throttle to the next vsync of the fake display.  If the application has fallen behind, the missed vsyncs are
+    // simply skipped, the same way a real compositor would drop frames.
+    const auto period = g_instance->config.displayPeriod();
+    auto currentTime = now();
+    XrTime nextVsync = ((currentTime / period) + 1) * period;
+    std::this_thread::sleep_for(std::chrono::nanoseconds(nextVsync - currentTime));
+
+    frameState->predictedDisplayPeriod = period;
+    frameState->predictedDisplayTime = nextVsync + period;
+    const XrSessionState state = target->state;
+    frameState->shouldRender = (state == XR_SESSION_STATE_VISIBLE || state == XR_SESSION_STATE_FOCUSED);
+    {
+        std::unique_lock<std::mutex> lock(target->frameMutex);
+        ++target->waitedFrames;
+        target->lastDisplayTime = frameState->predictedDisplayTime;
+    }
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL xrBeginFrame(XrSession session, const XrFrameBeginInfo* frameBeginInfo) {
+    auto target = fromHandle<Session>(session);
+    XrResult result = XR_SUCCESS;
+    {
+        std::unique_lock<std::mutex> lock(target->frameMutex);
+        if (target->begunFrames >= target->waitedFrames) {
+            return XR_ERROR_CALL_ORDER_INVALID;
+        }
+        if (target->frameInProgress) {
+            result = XR_FRAME_DISCARDED;
+        }
+        target->frameInProgress = true;
+        ++target->begunFrames;
+    }
+    target->frameConditional.notify_all();
+    return result;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL xrEndFrame(XrSession session, const XrFrameEndInfo* frameEndInfo) {
+    auto target = fromHandle<Session>(session);
+    std::unique_lock<std::mutex> lock(target->frameMutex);
+    if (!target->frameInProgress) {
+        return XR_ERROR_CALL_ORDER_INVALID;
+    }
+    if (frameEndInfo->displayTime <= 0) {
+        return XR_ERROR_TIME_INVALID;
+    }
+    target->frameInProgress = false;
+    ++target->endedFrames;
+    return XR_SUCCESS;
+}
+
+//
+// Dispatch
+//
+
+#define MOCK_FUNCTION(name) { #name, reinterpret_cast<PFN_xrVoidFunction>(&name) }
+
+static XRAPI_ATTR XrResult XRAPI_CALL xrGetInstanceProcAddr(XrInstance instance, const char* name, PFN_xrVoidFunction* function) {
+    static const std::unordered_map<std::string, PFN_xrVoidFunction> FUNCTIONS{
+        MOCK_FUNCTION(xrGetInstanceProcAddr),
+        MOCK_FUNCTION(xrEnumerateInstanceExtensionProperties),
+        MOCK_FUNCTION(xrEnumerateApiLayerProperties),
+        MOCK_FUNCTION(xrCreateInstance),
+        MOCK_FUNCTION(xrDestroyInstance),
+        MOCK_FUNCTION(xrGetInstanceProperties),
+        MOCK_FUNCTION(xrPollEvent),
+        MOCK_FUNCTION(xrResultToString),
+        MOCK_FUNCTION(xrStructureTypeToString),
+        MOCK_FUNCTION(xrGetSystem),
+        MOCK_FUNCTION(xrGetSystemProperties),
+        MOCK_FUNCTION(xrEnumerateEnvironmentBlendModes),
+        MOCK_FUNCTION(xrEnumerateViewConfigurations),
+        MOCK_FUNCTION(xrGetViewConfigurationProperties),
+        MOCK_FUNCTION(xrEnumerateViewConfigurationViews),
+        MOCK_FUNCTION(xrGetOpenGLGraphicsRequirementsKHR),
+        MOCK_FUNCTION(xrCreateSession),
+        MOCK_FUNCTION(xrDestroySession),
+        MOCK_FUNCTION(xrBeginSession),
+        MOCK_FUNCTION(xrEndSession),
+        MOCK_FUNCTION(xrRequestExitSession),
+        MOCK_FUNCTION(xrWaitFrame),
+        MOCK_FUNCTION(xrBeginFrame),
+        MOCK_FUNCTION(xrEndFrame),
+        MOCK_FUNCTION(xrEnumerateSwapchainFormats),
+        MOCK_FUNCTION(xrCreateSwapchain),
+        MOCK_FUNCTION(xrDestroySwapchain),
+        MOCK_FUNCTION(xrEnumerateSwapchainImages),
+        MOCK_FUNCTION(xrAcquireSwapchainImage),
+        MOCK_FUNCTION(xrWaitSwapchainImage),
+        MOCK_FUNCTION(xrReleaseSwapchainImage),
+        MOCK_FUNCTION(xrStringToPath),
+        MOCK_FUNCTION(xrPathToString),
+        MOCK_FUNCTION(xrCreateActionSet),
+        MOCK_FUNCTION(xrDestroyActionSet),
+        MOCK_FUNCTION(xrCreateAction),
+        MOCK_FUNCTION(xrDestroyAction),
+        MOCK_FUNCTION(xrSuggestInteractionProfileBindings),
+        MOCK_FUNCTION(xrAttachSessionActionSets),
+        MOCK_FUNCTION(xrGetCurrentInteractionProfile),
+        MOCK_FUNCTION(xrSyncActions),
+        MOCK_FUNCTION(xrGetActionStateBoolean),
+        MOCK_FUNCTION(xrGetActionStateFloat),
+        MOCK_FUNCTION(xrGetActionStateVector2f),
+        MOCK_FUNCTION(xrGetActionStatePose),
+        MOCK_FUNCTION(xrApplyHapticFeedback),
+        MOCK_FUNCTION(xrStopHapticFeedback),
+        MOCK_FUNCTION(xrEnumerateReferenceSpaces),
+        MOCK_FUNCTION(xrCreateReferenceSpace),
+        MOCK_FUNCTION(xrGetReferenceSpaceBoundsRect),
+        MOCK_FUNCTION(xrCreateActionSpace),
+        MOCK_FUNCTION(xrLocateSpace),
+        MOCK_FUNCTION(xrDestroySpace),
+        MOCK_FUNCTION(xrLocateViews),
+    };
+
+    if (nullptr == name || nullptr == function) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+
+    auto itr = FUNCTIONS.find(name);
+    if (itr == FUNCTIONS.end()) {
+        *function = nullptr;
+        return XR_ERROR_FUNCTION_UNSUPPORTED;
+    }
+
+    // Before an instance exists, only the functions needed to create one may be queried
+    if (XR_NULL_HANDLE == instance) {
+        static const std::vector<std::string> PRE_INSTANCE_FUNCTIONS{ "xrEnumerateInstanceExtensionProperties",
+                                                                      "xrEnumerateApiLayerProperties",
+                                                                      "xrCreateInstance", "xrGetInstanceProcAddr" };
+        if (PRE_INSTANCE_FUNCTIONS.end() == std::find(PRE_INSTANCE_FUNCTIONS.begin(), PRE_INSTANCE_FUNCTIONS.end(), name)) {
+            *function = nullptr;
+            return XR_ERROR_HANDLE_INVALID;
+        }
+    }
+
+    *function = itr->second;
+    return XR_SUCCESS;
+}
+
+#undef MOCK_FUNCTION
+
+}  // namespace mock
+
+MOCK_RUNTIME_EXPORT XRAPI_ATTR XrResult XRAPI_CALL xrNegotiateLoaderRuntimeInterface(const XrNegotiateLoaderInfo* loaderInfo,
+                                                                                     XrNegotiateRuntimeRequest* runtimeRequest) {
+    if (nullptr == loaderInfo || nullptr == runtimeRequest ||
+        loaderInfo->structType != XR_LOADER_INTERFACE_STRUCT_LOADER_INFO ||
+        loaderInfo->structVersion != XR_LOADER_INFO_STRUCT_VERSION || loaderInfo->structSize != sizeof(XrNegotiateLoaderInfo) ||
+        runtimeRequest->structType != XR_LOADER_INTERFACE_STRUCT_RUNTIME_REQUEST ||
+        runtimeRequest->structVersion != XR_RUNTIME_INFO_STRUCT_VERSION ||
+        runtimeRequest->structSize != sizeof(XrNegotiateRuntimeRequest)) {
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+
+    if (loaderInfo->minInterfaceVersion > XR_CURRENT_LOADER_RUNTIME_VERSION ||
+        loaderInfo->maxInterfaceVersion < XR_CURRENT_LOADER_RUNTIME_VERSION) {
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+
+    runtimeRequest->runtimeInterfaceVersion = XR_CURRENT_LOADER_RUNTIME_VERSION;
+    runtimeRequest->runtimeApiVersion = XR_CURRENT_API_VERSION;
+    runtimeRequest->getInstanceProcAddr = &mock::xrGetInstanceProcAddr;
+    return XR_SUCCESS;
+}
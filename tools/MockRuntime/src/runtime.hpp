@@ -0,0 +1,188 @@
+//
+//  Created by Bradley Austin Davis
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#pragma once
+
+#include <glad/glad.h>
+
+// The runtime must never call back into the loader
+#define XR_NO_PROTOTYPES
+#define XR_USE_GRAPHICS_API_OPENGL
+#include <openxr/openxr.h>
+#include <openxr/openxr_platform.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// A headless OpenXR runtime that fakes a stereo HMD, so that the example frame loop can be exercised and
+// benchmarked without a headset.  Swapchain images are plain GL textures created on whatever context is current
+// when the swapchain is created, and nothing is ever composited.
+//
+// The fake system is configured through the environment:
+//   XR_MOCK_IMAGE_WIDTH / XR_MOCK_IMAGE_HEIGHT   recommended per-eye image size (default 1440x1600)
+//   XR_MOCK_DISPLAY_HZ                           display refresh rate used to pace xrWaitFrame (default 90)
+//   XR_MOCK_SWAPCHAIN_LENGTH                     number of images per swapchain (default 3)
+namespace mock {
+
+// Horizontal and vertical half angle of each eye's field of view
+static const float MOCK_FOV_HALF_ANGLE{ 0.785f };
+
+struct Config {
+    uint32_t imageWidth{ 1440 };
+    uint32_t imageHeight{ 1600 };
+    double displayHz{ 90.0 };
+    uint32_t swapchainLength{ 3 };
+
+    static Config fromEnvironment();
+    XrDuration displayPeriod() const { return (XrDuration)(1.0e9 / displayHz); }
+};
+
+struct Swapchain {
+    XrSwapchainCreateInfo createInfo;
+    std::vector<uint32_t> textures;
+    std::deque<uint32_t> acquired;
+    uint32_t nextIndex{ 0 };
+    bool waited{ false };
+};
+
+struct ActionSet {
+    std::string name;
+    bool attached{ false };
+};
+
+struct Action {
+    XrActionSet actionSet{ XR_NULL_HANDLE };
+    XrActionType type{ XR_ACTION_TYPE_BOOLEAN_INPUT };
+    std::string name;
+};
+
+struct Space {
+    XrReferenceSpaceType referenceType{ XR_REFERENCE_SPACE_TYPE_LOCAL };
+    XrAction action{ XR_NULL_HANDLE };
+    XrPath subactionPath{ XR_NULL_PATH };
+    XrPosef poseInSpace{ { 0, 0, 0, 1 }, { 0, 0, 0 } };
+};
+
+struct Session {
+    // Set by xrRequestExitSession, which may be called from another thread than xrWaitFrame
+    std::atomic<XrSessionState> state{ XR_SESSION_STATE_UNKNOWN };
+    bool running{ false };
+    bool exitRequested{ false };
+    bool frameInProgress{ false };
+
+    // xrWaitFrame may be called from a different thread than xrBeginFrame, and must block until the previously
+    // waited frame has been begun.
+    std::mutex frameMutex;
+    std::condition_variable frameConditional;
+    uint64_t waitedFrames{ 0 };
+    uint64_t begunFrames{ 0 };
+    uint64_t endedFrames{ 0 };
+    XrTime lastDisplayTime{ 0 };
+};
+
+struct Instance {
+    Config config;
+    std::mutex mutex;
+    std::deque<XrEventDataBuffer> events;
+    Session* session{ nullptr };
+
+    void queueSessionState(XrSessionState state);
+};
+
+extern Instance* g_instance;
+
+XrTime now();
+inline double toSeconds(XrTime time) {
+    return (double)time / 1.0e9;
+}
+XrPath getPath(const std::string& path);
+const std::string& getPathString(XrPath path);
+
+// Fake tracking, as a function of time
+XrPosef getHeadPose(XrTime time);
+XrPosef getEyePose(XrTime time, uint32_t eye);
+XrPosef getHandPose(XrTime time, XrPath subactionPath);
+XrPosef getSpacePose(const Space& space, XrTime time);
+XrPosef multiply(const XrPosef& a, const XrPosef& b);
+XrPosef invert(const XrPosef& pose);
+
+template <typename T>
+XrResult fillArray(uint32_t capacityInput, uint32_t* countOutput, T* output, const std::vector<T>& values) {
+    if (nullptr == countOutput) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    *countOutput = (uint32_t)values.size();
+    if (0 == capacityInput) {
+        return XR_SUCCESS;
+    }
+    if (capacityInput < values.size()) {
+        return XR_ERROR_SIZE_INSUFFICIENT;
+    }
+    for (size_t i = 0; i < values.size(); ++i) {
+        output[i] = values[i];
+    }
+    return XR_SUCCESS;
+}
+
+template <typename T, typename H>
+T* fromHandle(H handle) {
+    return reinterpret_cast<T*>(handle);
+}
+
+template <typename H, typename T>
+H toHandle(T* object) {
+    return reinterpret_cast<H>(object);
+}
+
+// Swapchain entry points, see swapchain.cpp
+XRAPI_ATTR XrResult XRAPI_CALL xrEnumerateSwapchainFormats(XrSession, uint32_t, uint32_t*, int64_t*);
+XRAPI_ATTR XrResult XRAPI_CALL xrCreateSwapchain(XrSession, const XrSwapchainCreateInfo*, XrSwapchain*);
+XRAPI_ATTR XrResult XRAPI_CALL xrDestroySwapchain(XrSwapchain);
+XRAPI_ATTR XrResult XRAPI_CALL xrEnumerateSwapchainImages(XrSwapchain, uint32_t, uint32_t*, XrSwapchainImageBaseHeader*);
+XRAPI_ATTR XrResult XRAPI_CALL xrAcquireSwapchainImage(XrSwapchain, const XrSwapchainImageAcquireInfo*, uint32_t*);
+XRAPI_ATTR XrResult XRAPI_CALL xrWaitSwapchainImage(XrSwapchain, const XrSwapchainImageWaitInfo*);
+XRAPI_ATTR XrResult XRAPI_CALL xrReleaseSwapchainImage(XrSwapchain, const XrSwapchainImageReleaseInfo*);
+
+// Action and space entry points, see input.cpp
+XRAPI_ATTR XrResult XRAPI_CALL xrStringToPath(XrInstance, const char*, XrPath*);
+XRAPI_ATTR XrResult XRAPI_CALL xrPathToString(XrInstance, XrPath, uint32_t, uint32_t*, char*);
+XRAPI_ATTR XrResult XRAPI_CALL xrCreateActionSet(XrInstance, const XrActionSetCreateInfo*, XrActionSet*);
+XRAPI_ATTR XrResult XRAPI_CALL xrDestroyActionSet(XrActionSet);
+XRAPI_ATTR XrResult XRAPI_CALL xrCreateAction(XrActionSet, const XrActionCreateInfo*, XrAction*);
+XRAPI_ATTR XrResult XRAPI_CALL xrDestroyAction(XrAction);
+XRAPI_ATTR XrResult XRAPI_CALL xrSuggestInteractionProfileBindings(XrInstance,
+                                                                     const XrInteractionProfileSuggestedBinding*);
+XRAPI_ATTR XrResult XRAPI_CALL xrAttachSessionActionSets(XrSession, const XrSessionActionSetsAttachInfo*);
+XRAPI_ATTR XrResult XRAPI_CALL xrGetCurrentInteractionProfile(XrSession, XrPath, XrInteractionProfileState*);
+XRAPI_ATTR XrResult XRAPI_CALL xrSyncActions(XrSession, const XrActionsSyncInfo*);
+XRAPI_ATTR XrResult XRAPI_CALL xrGetActionStateBoolean(XrSession, const XrActionStateGetInfo*, XrActionStateBoolean*);
+XRAPI_ATTR XrResult XRAPI_CALL xrGetActionStateFloat(XrSession, const XrActionStateGetInfo*, XrActionStateFloat*);
+XRAPI_ATTR XrResult XRAPI_CALL xrGetActionStateVector2f(XrSession, const XrActionStateGetInfo*, XrActionStateVector2f*);
+XRAPI_ATTR XrResult XRAPI_CALL xrGetActionStatePose(XrSession, const XrActionStateGetInfo*, XrActionStatePose*);
+XRAPI_ATTR XrResult XRAPI_CALL xrApplyHapticFeedback(XrSession, const XrHapticActionInfo*, const XrHapticBaseHeader*);
+XRAPI_ATTR XrResult XRAPI_CALL xrStopHapticFeedback(XrSession, const XrHapticActionInfo*);
+XRAPI_ATTR XrResult XRAPI_CALL xrEnumerateReferenceSpaces(XrSession, uint32_t, uint32_t*, XrReferenceSpaceType*);
+XRAPI_ATTR XrResult XRAPI_CALL xrCreateReferenceSpace(XrSession, const XrReferenceSpaceCreateInfo*, XrSpace*);
+XRAPI_ATTR XrResult XRAPI_CALL xrGetReferenceSpaceBoundsRect(XrSession, XrReferenceSpaceType, XrExtent2Df*);
+XRAPI_ATTR XrResult XRAPI_CALL xrCreateActionSpace(XrSession, const XrActionSpaceCreateInfo*, XrSpace*);
+XRAPI_ATTR XrResult XRAPI_CALL xrLocateSpace(XrSpace, XrSpace, XrTime, XrSpaceLocation*);
+XRAPI_ATTR XrResult XRAPI_CALL xrDestroySpace(XrSpace);
+XRAPI_ATTR XrResult XRAPI_CALL xrLocateViews(XrSession,
+                                             const XrViewLocateInfo*,
+                                             XrViewState*,
+                                             uint32_t,
+                                             uint32_t*,
+                                             XrView*);
+
+}  // namespace mock
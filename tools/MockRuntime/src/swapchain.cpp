@@ -0,0 +1,114 @@
+//
+//  Created by Bradley Austin Davis
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#include "runtime.hpp"
+
+#include <algorithm>
+
+namespace mock {
+
+// Color formats first, in order of preference, then depth formats
+static const std::vector<int64_t> SUPPORTED_FORMATS{
+    GL_SRGB8_ALPHA8, GL_RGBA8, GL_DEPTH24_STENCIL8, GL_DEPTH_COMPONENT32F, GL_DEPTH_COMPONENT24, GL_DEPTH_COMPONENT16,
+};
+
+XRAPI_ATTR XrResult XRAPI_CALL xrEnumerateSwapchainFormats(XrSession session,
+                                                           uint32_t formatCapacityInput,
+                                                           uint32_t* formatCountOutput,
+                                                           int64_t* formats) {
+    return fillArray(formatCapacityInput, formatCountOutput, formats, SUPPORTED_FORMATS);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrCreateSwapchain(XrSession session,
+                                                 const XrSwapchainCreateInfo* createInfo,
+                                                 XrSwapchain* swapchain) {
+    if (SUPPORTED_FORMATS.end() == std::find(SUPPORTED_FORMATS.begin(), SUPPORTED_FORMATS.end(), createInfo->format)) {
+        return XR_ERROR_SWAPCHAIN_FORMAT_UNSUPPORTED;
+    }
+    if (createInfo->faceCount != 1 || createInfo->mipCount != 1 || createInfo->sampleCount != 1 ||
+        createInfo->arraySize < 1 || createInfo->width == 0 || createInfo->height == 0) {
+        return XR_ERROR_FEATURE_UNSUPPORTED;
+    }
+
+    auto target = new Swapchain();
+    target->createInfo = *createInfo;
+    target->createInfo.next = nullptr;
+    target->textures.resize(g_instance->config.swapchainLength);
+
+    // The images are created on the context that is current when the swapchain is created, which for the examples is
+    // always shared with the context that renders into them
+    auto textureTarget = createInfo->arraySize > 1 ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D;
+    glCreateTextures(textureTarget, (GLsizei)target->textures.size(), target->textures.data());
+    for (auto texture : target->textures) {
+        if (createInfo->arraySize > 1) {
+            glTextureStorage3D(texture, 1, (GLenum)createInfo->format, createInfo->width, createInfo->height,
+                               createInfo->arraySize);
+        } else {
+            glTextureStorage2D(texture, 1, (GLenum)createInfo->format, createInfo->width, createInfo->height);
+        }
+    }
+
+    *swapchain = toHandle<XrSwapchain>(target);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrDestroySwapchain(XrSwapchain swapchain) {
+    auto target = fromHandle<Swapchain>(swapchain);
+    if (nullptr == target) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    glDeleteTextures((GLsizei)target->textures.size(), target->textures.data());
+    delete target;
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrEnumerateSwapchainImages(XrSwapchain swapchain,
+                                                          uint32_t imageCapacityInput,
+                                                          uint32_t* imageCountOutput,
+                                                          XrSwapchainImageBaseHeader* images) {
+    auto target = fromHandle<Swapchain>(swapchain);
+    std::vector<XrSwapchainImageOpenGLKHR> glImages;
+    glImages.reserve(target->textures.size());
+    for (auto texture : target->textures) {
+        glImages.push_back({ XR_TYPE_SWAPCHAIN_IMAGE_OPENGL_KHR, nullptr, texture });
+    }
+    return fillArray(imageCapacityInput, imageCountOutput, reinterpret_cast<XrSwapchainImageOpenGLKHR*>(images), glImages);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrAcquireSwapchainImage(XrSwapchain swapchain,
+                                                       const XrSwapchainImageAcquireInfo* acquireInfo,
+                                                       uint32_t* index) {
+    auto target = fromHandle<Swapchain>(swapchain);
+    if (target->acquired.size() >= target->textures.size()) {
+        return XR_ERROR_CALL_ORDER_INVALID;
+    }
+    *index = target->nextIndex;
+    target->acquired.push_back(target->nextIndex);
+    target->nextIndex = (target->nextIndex + 1) % (uint32_t)target->textures.size();
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrWaitSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageWaitInfo* waitInfo) {
+    auto target = fromHandle<Swapchain>(swapchain);
+    if (target->acquired.empty() || target->waited) {
+        return XR_ERROR_CALL_ORDER_INVALID;
+    }
+    // Nothing ever composites from the images, so they are always immediately available
+    target->waited = true;
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrReleaseSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageReleaseInfo* releaseInfo) {
+    auto target = fromHandle<Swapchain>(swapchain);
+    if (target->acquired.empty() || !target->waited) {
+        return XR_ERROR_CALL_ORDER_INVALID;
+    }
+    target->acquired.pop_front();
+    target->waited = false;
+    return XR_SUCCESS;
+}
+
+}  // namespace mock
@@ -0,0 +1,381 @@
+//
+//  Created by Bradley Austin Davis
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#define XR_USE_GRAPHICS_API_OPENGL
+
+#include <openxrExampleBase.hpp>
+#include <magnum/scene.hpp>
+#include <magnum/framebuffer.hpp>
+#include <magnum/window.hpp>
+#include <logging.hpp>
+#include <parallelFor.hpp>
+
+using namespace xr_examples;
+using WindowType = magnum::Window;
+using FramebufferType = magnum::Framebuffer;
+using SceneType = magnum::Scene;
+using ExampleType = OpenXrExampleBase<WindowType, FramebufferType, SceneType>;
+
+// Drives the example frame loop for a fixed number of frames and reports the distribution of frame times, along with
+// what the flags below turn on, to compare runs with and without them.  Unless XR_RUNTIME_JSON is already set, the
+// loader is pointed at the mock runtime from tools/MockRuntime, so the benchmark runs without a headset (and under a
+// software GL driver, e.g. LIBGL_ALWAYS_SOFTWARE=1 on Mesa).
+//
+// Usage: XrBench [flags]
+//
+//   Flag                        Default       Meaning
+//   --frames N                  1000          Frames measured, after the warmup
+//   --warmup N                  60            Frames run before measuring
+//   --model path                models/2CylinderEngine.glb
+//                                             Model loaded into the scene
+//   --output path               none          Write the per-frame timings, as .csv or .json
+//   --pipelined                 off           Pipeline the frame loop
+//   --late-latch                off           Late latch the eye poses
+//   --adaptive-resolution       off           Scale the render target to the frame time
+//   --direct                    off           Render straight into the swapchain images, skipping the blit
+//   --depth                     off           Submit the depth buffer
+//   --foveated                  off           Render each eye's periphery at lower resolution than an inset
+//   --foveation-inset F         0.5           Fraction of each eye's size covered by the inset
+//   --foveation-periphery F     0.5           Resolution scale of the periphery
+//   --mirror off|left|both      both          Eyes shown in the desktop mirror
+//   --mirror-interval N         1             Mirror every Nth frame
+//   --async-mirror              off           Present the mirror from a thread of its own
+//   --scene-threads N           1             Threads the scene graph traversal is split across
+//   --scene-thread-sweep        off           Split the frames evenly between 1 to N traversal threads
+//   --synthetic-nodes N         0             Replace the model with N cubes, when not 0
+//   --no-instancing             instanced     Draw every mesh node on its own, not one instanced draw per mesh
+//   --stereo-instancing         off           Draw the model once for both eyes
+//   --culling none|stereo|per-eye
+//                               stereo        Frustums the drawables are culled against
+//   --no-uniform-buffer         buffered      Set the eyes and the light with every draw, not once a frame
+//   --no-draw-sort              sorted        Submit the draws in the order the drawables were added, unsorted
+//   --no-batching               batched       Draw each mesh from its own buffers, not a multi-draw per texture
+//   --record path               off           Record the XR input
+//   --replay path               off           Replay recorded XR input instead of using an XR runtime
+class FrameLoopBenchmark : public ExampleType {
+    using Parent = ExampleType;
+
+public:
+    uint32_t benchmarkFrames{ 1000 };
+    uint32_t warmupFrames{ 60 };
+    std::string modelPath{ "models/2CylinderEngine.glb" };
+    uint32_t sceneThreads{ 1 };
+    bool sceneThreadSweep{ false };
+    uint32_t syntheticNodes{ 0 };
+    bool instancing{ true };
+    bool stereoInstancing{ false };
+    magnum::Scene::Culling culling{ magnum::Scene::Culling::Stereo };
+    bool uniformBuffer{ true };
+    bool drawSorting{ true };
+    bool batching{ true };
+
+    FrameLoopBenchmark() {
+        parseArguments();
+#if defined(MOCK_RUNTIME_MANIFEST)
+        if (!getenv("XR_RUNTIME_JSON")) {
+#if defined(WIN32)
+            _putenv_s("XR_RUNTIME_JSON", MOCK_RUNTIME_MANIFEST);
+#else
+            setenv("XR_RUNTIME_JSON", MOCK_RUNTIME_MANIFEST, 1);
+#endif
+        }
+#endif
+        frameIntervals.reserve(benchmarkFrames);
+        frameDurations.reserve(benchmarkFrames);
+        poseAges.reserve(benchmarkFrames);
+        renderScales.reserve(benchmarkFrames);
+        blitDurations.reserve(benchmarkFrames);
+    }
+
+    void parseArguments() {
+        for (int i = 1; i < g_argc; ++i) {
+            std::string argument = g_argv[i];
+            bool hasValue = (i + 1) < g_argc;
+            if (argument == "--frames" && hasValue) {
+                benchmarkFrames = (uint32_t)atoi(g_argv[++i]);
+            } else if (argument == "--warmup" && hasValue) {
+                warmupFrames = (uint32_t)atoi(g_argv[++i]);
+            } else if (argument == "--model" && hasValue) {
+                modelPath = g_argv[++i];
+            } else if (argument == "--output" && hasValue) {
+                frameTimingsPath = g_argv[++i];
+            } else if (argument == "--pipelined") {
+                pipelinedFrameLoop = true;
+            } else if (argument == "--late-latch") {
+                lateLatchEyePoses = true;
+            } else if (argument == "--adaptive-resolution") {
+                adaptiveResolution = true;
+            } else if (argument == "--direct") {
+                renderDirectToSwapchain = true;
+            } else if (argument == "--depth") {
+                submitDepth = true;
+            } else if (argument == "--foveated") {
+                foveatedRendering = true;
+            } else if (argument == "--foveation-inset" && hasValue) {
+                foveation.insetFraction = (float)atof(g_argv[++i]);
+            } else if (argument == "--foveation-periphery" && hasValue) {
+                foveation.peripheryScale = (float)atof(g_argv[++i]);
+            } else if (argument == "--mirror" && hasValue) {
+                std::string mode = g_argv[++i];
+                if (mode == "off") {
+                    mirrorMode = gl::Mirror::Mode::Off;
+                } else if (mode == "left") {
+                    mirrorMode = gl::Mirror::Mode::LeftEye;
+                } else if (mode == "both") {
+                    mirrorMode = gl::Mirror::Mode::BothEyes;
+                } else {
+                    LOG_WARN("Ignoring unknown mirror mode {}", mode);
+                }
+            } else if (argument == "--mirror-interval" && hasValue) {
+                mirrorInterval = (uint32_t)atoi(g_argv[++i]);
+            } else if (argument == "--async-mirror") {
+                asyncMirror = true;
+            } else if (argument == "--scene-threads" && hasValue) {
+                sceneThreads = std::clamp<uint32_t>((uint32_t)atoi(g_argv[++i]), 1, ParallelFor::MAX_THREADS);
+            } else if (argument == "--scene-thread-sweep") {
+                sceneThreadSweep = true;
+            } else if (argument == "--synthetic-nodes" && hasValue) {
+                syntheticNodes = (uint32_t)atoi(g_argv[++i]);
+            } else if (argument == "--no-instancing") {
+                instancing = false;
+            } else if (argument == "--stereo-instancing") {
+                stereoInstancing = true;
+            } else if (argument == "--culling" && hasValue) {
+                std::string value = g_argv[++i];
+                if (value == "none") {
+                    culling = magnum::Scene::Culling::None;
+                } else if (value == "stereo") {
+                    culling = magnum::Scene::Culling::Stereo;
+                } else if (value == "per-eye") {
+                    culling = magnum::Scene::Culling::PerEye;
+                } else {
+                    LOG_WARN("Ignoring unknown culling mode {}", value);
+                }
+            } else if (argument == "--no-uniform-buffer") {
+                uniformBuffer = false;
+            } else if (argument == "--no-draw-sort") {
+                drawSorting = false;
+            } else if (argument == "--no-batching") {
+                batching = false;
+            } else if (argument == "--record" && hasValue) {
+                recordInputPath = g_argv[++i];
+            } else if (argument == "--replay" && hasValue) {
+                replayInputPath = g_argv[++i];
+            } else {
+                LOG_WARN("Ignoring unknown argument {}", argument);
+            }
+        }
+    }
+
+    void prepareScene() override {
+        scene.create();
+        scene.setInstancing(instancing);
+        scene.setStereoInstancing(stereoInstancing);
+        scene.setCulling(culling);
+        scene.setUniformBuffer(uniformBuffer);
+        scene.setDrawSorting(drawSorting);
+        scene.setBatching(batching);
+        if (syntheticNodes != 0) {
+            scene.loadSyntheticScene(syntheticNodes);
+        } else {
+            scene.loadModel(assets::getAssetPathString(modelPath));
+        }
+        scene.setCubemap(assets::getAssetPathString("yokohama.basis"));
+        scene.setThreadCount(sceneThreadSweep ? 1 : sceneThreads);
+        traversalTimes.resize(sceneThreads);
+    }
+
+    bool update(float delta) override {
+        if ((isReplaying() || xrContext.shouldRender()) && frameTimings.size() != 0) {
+            collectLastFrame();
+        }
+        return Parent::update(delta);
+    }
+
+    void report() const {
+        LOG_INFO("XrBench: {} frames, {}{}{}{}{}{}", frameDurations.size(),
+                 isReplaying() ? "replayed input" : (pipelinedFrameLoop ? "pipelined" : "serial"),
+                 lateLatchEyePoses ? ", late latched eye poses" : "", adaptiveResolution ? ", adaptive resolution" : "",
+                 isRenderingDirectToSwapchain() ? ", direct to swapchain" : "", isSubmittingDepth() ? ", depth submitted" : "",
+                 isFoveated() ? ", foveated" : "");
+        reportDistribution("frame interval", frameIntervals);
+        reportDistribution("frame duration (excluding waitFrame)", frameDurations);
+        gl::Profiler::ZoneResult sceneResult;
+        if (profiler.getZoneResult(gl::zone::SCENE, sceneResult)) {
+            gl::Profiler::ZoneResult insetResult;
+            if (isFoveated() && profiler.getZoneResult(gl::zone::FOVEATED_INSET, insetResult)) {
+                LOG_INFO("    scene (GPU): avg {:.3f} ms (periphery {:.3f} ms + inset {:.3f} ms), {:.0f}% of the pixels shaded",
+                         sceneResult.avg + insetResult.avg, sceneResult.avg, insetResult.avg,
+                         100.0f * foveation.getShadedFraction());
+            } else {
+                LOG_INFO("    scene (GPU): avg {:.3f} ms, max {:.3f} ms", sceneResult.avg, sceneResult.max);
+            }
+        }
+        reportDistribution("blit to projection (CPU)", blitDurations);
+        gl::Profiler::ZoneResult blitResult;
+        if (profiler.getZoneResult(gl::zone::BLIT_TO_PROJECTION, blitResult)) {
+            LOG_INFO("    blit to projection (GPU): avg {:.3f} ms, max {:.3f} ms", blitResult.avg, blitResult.max);
+        }
+        if (!isReplaying()) {
+            // An RGBA8 read and write of the whole double-wide target per frame, regardless of any render scale
+            auto blitBytes = isRenderingDirectToSwapchain() ? 0.0
+                                                            : (double)renderTargetSize.width * renderTargetSize.height * 8.0;
+            LOG_INFO("    blit to projection traffic: {:.2f} MB/frame, {:.1f} MB/s at the display rate", blitBytes / 1.0e6,
+                     displayPeriod > 0.0f ? blitBytes / 1.0e3 / displayPeriod : 0.0);
+        }
+        gl::Profiler::ZoneResult mirrorResult;
+        if (profiler.getZoneResult(gl::zone::MIRROR_BLIT, mirrorResult)) {
+            LOG_INFO("    mirror (GPU): avg {:.3f} ms, max {:.3f} ms, every {} frame(s){}", mirrorResult.avg, mirrorResult.max,
+                     std::max(mirrorInterval, 1u), mirror.isAsync() ? ", presented asynchronously" : "");
+        }
+        reportTraversalScaling();
+        reportDistribution("scene submit (CPU)", submitTimes);
+        const auto& sceneStats = scene.getStats();
+        LOG_INFO("    scene draw calls: {} per frame, {} instanced nodes in {} instanced draws {}", sceneStats.drawCalls,
+                 sceneStats.instances, sceneStats.instanceGroups, stereoInstancing ? "for both eyes" : "per eye");
+        if (batching) {
+            LOG_INFO("    scene multi-draws: {} of the draw calls, over a static batch", sceneStats.multiDraws);
+        }
+        LOG_INFO("    scene state changes: {} shader and {} texture binds per frame, {}", sceneStats.shaderChanges,
+                 sceneStats.materialChanges, drawSorting ? "sorted" : "unsorted");
+        if (culling != magnum::Scene::Culling::None) {
+            reportDistribution(fmt::format("scene drawables culled, of {}", sceneStats.drawables), culledDrawables, "");
+            reportDistribution("scene subtrees culled whole", culledSubtrees, "");
+            if (sceneStats.instances != 0) {
+                reportDistribution(fmt::format("scene instances culled, of {}", sceneStats.instances), culledInstances, "");
+            }
+        }
+        if (culling == magnum::Scene::Culling::PerEye) {
+            reportDistribution("scene draws culled for one eye", culledForOneEye, "");
+        }
+        reportDistribution(uniformBuffer ? "scene uniform uploads (uniform buffer)" : "scene uniform uploads (per draw)",
+                           uniformBytes, " bytes");
+        reportDistribution("eye pose age at submission", poseAges);
+        if (adaptiveResolution) {
+            reportDistribution("render scale", renderScales, "");
+        }
+        uint32_t missedFrames = 0;
+        for (const auto& interval : frameIntervals) {
+            if (interval > displayPeriod * 1.5f) {
+                ++missedFrames;
+            }
+        }
+        LOG_INFO("    missed vsyncs: {} ({:.2f}%)", missedFrames,
+                 frameIntervals.empty() ? 0.0f : 100.0f * (float)missedFrames / (float)frameIntervals.size());
+    }
+
+private:
+    // Called at the start of each frame with the timings of the previous one
+    void collectLastFrame() {
+        const auto& record = frameTimings.getRecord(0);
+        if (record.frameIndex == lastCollectedFrame) {
+            return;
+        }
+        lastCollectedFrame = record.frameIndex;
+        displayPeriod = (float)xrContext.frameState.predictedDisplayPeriod.get() / 1.0e6f;
+
+        if (warmupFrames != 0) {
+            --warmupFrames;
+            return;
+        }
+
+        // Replayed display times are the recorded ones, not those of this run
+        if (lastDisplayTime != 0 && !isReplaying()) {
+            frameIntervals.push_back((float)(record.predictedDisplayTime - lastDisplayTime) / 1.0e6f);
+        }
+        lastDisplayTime = record.predictedDisplayTime;
+
+        auto waitIndex = static_cast<size_t>(FramePhase::WaitFrame);
+        frameDurations.push_back(record.frameDuration - record.phaseDuration[waitIndex]);
+        if (record.poseAge >= 0.0f) {
+            poseAges.push_back(record.poseAge);
+        }
+        renderScales.push_back(record.renderScale);
+        blitDurations.push_back(record.phaseDuration[static_cast<size_t>(FramePhase::BlitToProjection)]);
+        const auto& sceneStats = scene.getStats();
+        traversalTimes[std::min<size_t>(sceneStats.threads, traversalTimes.size()) - 1].push_back(sceneStats.traversalTime);
+        submitTimes.push_back(sceneStats.submitTime);
+        culledDrawables.push_back((float)sceneStats.culled);
+        culledForOneEye.push_back((float)sceneStats.culledForOneEye);
+        culledSubtrees.push_back((float)sceneStats.culledSubtrees);
+        culledInstances.push_back((float)sceneStats.culledInstances);
+        uniformBytes.push_back((float)sceneStats.uniformBytes);
+        if (sceneThreadSweep) {
+            // An equal share of the frames for each thread count, from 1 up to `sceneThreads`
+            auto framesPerStep = std::max(benchmarkFrames / sceneThreads, 1u);
+            scene.setThreadCount(std::min((uint32_t)frameDurations.size() / framesPerStep + 1, sceneThreads));
+        }
+
+        if (frameDurations.size() == benchmarkFrames && !exitRequested) {
+            exitRequested = true;
+            if (isReplaying()) {
+                window.requestClose();
+            } else {
+                xrSession.requestExitSession();
+            }
+        }
+    }
+
+    void reportTraversalScaling() const {
+        float singleThreadAvg = 0.0f;
+        for (size_t i = 0; i < traversalTimes.size(); ++i) {
+            const auto& samples = traversalTimes[i];
+            if (samples.empty()) {
+                continue;
+            }
+            float avg = 0.0f;
+            for (const auto& sample : samples) {
+                avg += sample;
+            }
+            avg /= (float)samples.size();
+            if (i == 0) {
+                singleThreadAvg = avg;
+            }
+            LOG_INFO("    scene traversal (CPU): {} thread(s), {} drawables, avg {:.3f} ms{}", i + 1,
+                     scene.getStats().drawables, avg,
+                     singleThreadAvg > 0.0f && i != 0 ? fmt::format(", {:.2f}x", singleThreadAvg / avg) : "");
+        }
+    }
+
+    static void reportDistribution(const std::string& name, std::vector<float> samples, const char* unit = " ms") {
+        if (samples.empty()) {
+            return;
+        }
+        std::sort(samples.begin(), samples.end());
+        auto percentile = [&](float p) { return samples[std::min(samples.size() - 1, (size_t)(p * (float)samples.size()))]; };
+        float total = 0.0f;
+        for (const auto& sample : samples) {
+            total += sample;
+        }
+        LOG_INFO("    {0}: min {1:.3f}{7}, avg {2:.3f}{7}, p50 {3:.3f}{7}, p90 {4:.3f}{7}, p99 {5:.3f}{7}, max {6:.3f}{7}", name,
+                 samples.front(), total / (float)samples.size(), percentile(0.5f), percentile(0.9f), percentile(0.99f),
+                 samples.back(), unit);
+    }
+
+    std::vector<float> frameIntervals;
+    std::vector<float> frameDurations;
+    std::vector<float> poseAges;
+    std::vector<float> renderScales;
+    std::vector<float> blitDurations;
+    // Indexed by the number of traversal threads, less one
+    std::vector<std::vector<float>> traversalTimes;
+    std::vector<float> submitTimes;
+    std::vector<float> culledDrawables;
+    std::vector<float> culledForOneEye;
+    std::vector<float> culledSubtrees;
+    std::vector<float> culledInstances;
+    std::vector<float> uniformBytes;
+    uint64_t lastCollectedFrame{ 0 };
+    int64_t lastDisplayTime{ 0 };
+    float displayPeriod{ 0.0f };
+    bool exitRequested{ false };
+};
+
+ENTRY_POINT_START
+FrameLoopBenchmark benchmark;
+benchmark.run();
+benchmark.report();
+ENTRY_POINT_END